@@ -1,10 +1,13 @@
+#include <string>
+#include <vector>
+
 #include "lilia/uci/uci.hpp"
 
 #ifdef LILIA_UI
 #include "lilia/app/app.hpp"
 #endif
 
-int main() {
+int main(int argc, char** argv) {
 #ifdef LILIA_UI
 
   lilia::app::App app;
@@ -12,6 +15,12 @@ int main() {
 #elif defined(LILIA_ENGINE)
 
   lilia::UCI uci;
+  // lilia_engine bench [depth] [threads] [hash]
+  if (argc > 1 && std::string(argv[1]) == "bench")
+    return uci.bench(std::vector<std::string>(argv + 2, argv + argc));
+  // lilia_engine perft <depth> [threads] [fen]
+  if (argc > 1 && std::string(argv[1]) == "perft")
+    return uci.perft(std::vector<std::string>(argv + 2, argv + argc));
   return uci.run();
 #else
 #endif
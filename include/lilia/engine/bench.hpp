@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+
+#include "config.hpp"
+
+namespace lilia::engine {
+
+// Fester Benchmark: eingebettete Stellungen, jede mit frischer TT/History/Eval-Caches auf
+// fester Tiefe gesucht. Bei threads == 1 ist die Knotensumme eine deterministische Signatur
+// des Suchverhaltens (ändert sie sich, hat sich die Suche funktional geändert).
+// Dient auch als Trainingslauf für LILIA_PGO_GENERATE (Target pgo_train).
+inline constexpr int BENCH_DEPTH = 7;
+inline constexpr int BENCH_THREADS = 1;
+inline constexpr std::size_t BENCH_HASH_MB = 16;
+// Stop-Latenz: so viele Stellungen zusätzlich mit fester Zeit bis zur Deadline suchen
+inline constexpr int BENCH_STOP_PROBES = 10;
+inline constexpr int BENCH_STOP_MS = 20;
+
+struct BenchResult {
+  int positions = 0;
+  std::uint64_t nodes = 0;
+  std::uint64_t elapsedMs = 0;  // reine Suchzeit (ohne TT-Clear zwischen den Stellungen)
+  std::uint64_t nps = 0;
+  // Überschreitung der Deadline bis zur Rückkehr der Suche (nicht Teil von nodes/elapsedMs)
+  int stopProbes = 0;
+  double stopOvershootMaxMs = 0.0;
+  double stopOvershootAvgMs = 0.0;
+};
+
+// cfg liefert die Suchparameter; threads/ttSizeMb werden vom Aufrufer gesetzt.
+// progress (optional) bekommt eine Zeile pro Stellung.
+BenchResult run_bench(const EngineConfig& cfg, int depth, std::ostream* progress = nullptr);
+
+}  // namespace lilia::engine
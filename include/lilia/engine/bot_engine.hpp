@@ -1,6 +1,7 @@
 #pragma once
 
 #include <atomic>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <utility>
@@ -9,6 +10,7 @@
 #include "../model/move.hpp"
 #include "engine.hpp"
 #include "search.hpp"
+#include "time_manager.hpp"
 
 namespace lilia::model {
 class ChessGame;
@@ -28,14 +30,41 @@ class BotEngine {
   explicit BotEngine(const EngineConfig& cfg = {});
   ~BotEngine();
 
+  // thinkMillis > 0: feste Zeit (wie movetime, ohne Overhead), sonst ohne Zeitlimit
   SearchResult findBestMove(model::ChessGame& gameState, int maxDepth, int thinkMillis,
                             std::atomic<bool>* externalCancel = nullptr);
+  // Uhr-gesteuert (UCI wtime/btime/inc/movestogo/movetime), siehe TimeManager;
+  // goLimits: UCI nodes/mate/searchmoves
+  SearchResult findBestMove(model::ChessGame& gameState, int maxDepth, const TimeLimits& limits,
+                            std::atomic<bool>* externalCancel = nullptr,
+                            const SearchLimits& goLimits = {});
+
+  // Uhr der nächsten Suche schon beim "go" starten (UCI-Thread, vor dem Start der Suche in
+  // einem eigenen Thread); findBestMove() übernimmt sie dann statt neu zu starten. So trifft
+  // ein ponderhit, der vor dem eigentlichen Suchstart kommt, schon den richtigen TimeManager.
+  void startClock(const TimeLimits& limits);
+
+  // Aus einem anderen Thread: laufende "go ponder"-Suche in eine Suche mit Uhr umwandeln.
+  // false, wenn weder eine Suche läuft noch eine Uhr per startClock() gestartet ist.
+  bool ponderhit();
 
   // Direkt zugänglich, falls jemand Stats separat lesen will
   const engine::SearchStats& getLastSearchStats() const;
+  void setInfoCallback(InfoCallback cb);
+
+  // Session-Steuerung (UCI: setoption / ucinewgame)
+  void setConfig(const EngineConfig& cfg);
+  void newGame();
+  const EngineConfig& getConfig() const;
+  std::string ttPageDescription() const;
+  bool saveHash(const std::string& path) const;
+  bool loadHash(const std::string& path);
 
  private:
   Engine m_engine;
+  std::mutex m_tmMutex;
+  TimeManager m_tm;
+  TimeManager* m_activeTm = nullptr;  // &m_tm ab startClock()/Suchstart bis Suchende (ponderhit)
 };
 
 }  // namespace lilia::engine
@@ -5,8 +5,9 @@
 namespace lilia::engine {
 struct EngineConfig {
   int maxDepth = 12;  // etwas tiefer, ID hilft Stabilität
-  std::uint64_t maxNodes = 100000;
+  std::uint64_t maxNodes = 0;  // 0 = ohne Limit; UCI "go nodes" hat Vorrang
   std::size_t ttSizeMb = 1024;  // mehr TT entspannt Aspiration/Transpositionen
+  bool ttLargePages = true;     // hugetlb/THP für die TT versuchen (weniger TLB-Misses)
   bool useNullMove = true;      // gut für Mittelspiel, QS-Fixes mindern Risiken
   bool useLMR = true;           // leichte Reduktionen sind ok
   bool useAspiration = true;    // stabil mit Score-Normalisierung
@@ -36,6 +37,7 @@ struct EngineConfig {
   int lmrMax = 3;             // Deckel
   bool lmrUseHistory = true;  // gute History => weniger Reduktion
   int fullRescoreTopK = 4;    // 0 = none, 1 = only winner, N>1 = also N-1 others
+  int multiPV = 1;            // Analyse: so viele Wurzelzüge je Iteration mit exaktem Score
 };
 static const int base_value[6] = {100, 320, 330, 500, 950, 20000};
 constexpr int INF = 32000;
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <string>
 
 #include "../model/core/magic.hpp"
 #include "../model/move.hpp"
@@ -12,6 +14,9 @@
 
 namespace lilia::engine {
 struct SearchStats;
+struct SearchInfo;
+struct SearchLimits;
+class TimeManager;
 
 class Engine {
  public:
@@ -22,11 +27,35 @@ class Engine {
     static std::once_flag magic_once;
     std::call_once(magic_once, []() { lilia::model::magic::init_magics(); });
   }
+  // tm (optional, bereits gestartet): Soft-Limit zwischen den Iterationen, maximum() als
+  // Deadline, die die Such-Threads selbst prüfen. cancel: externes Abbruchsignal (UCI stop).
+  // limits (optional): go nodes/mate/searchmoves; ohne nodes gilt cfg.maxNodes.
   std::optional<model::Move> find_best_move(model::Position& pos, int maxDepth = 8,
-                                            std::shared_ptr<std::atomic<bool>> stop = nullptr);
+                                            std::shared_ptr<std::atomic<bool>> stop = nullptr,
+                                            TimeManager* tm = nullptr,
+                                            const std::atomic<bool>* cancel = nullptr,
+                                            const SearchLimits* limits = nullptr);
   const SearchStats& getLastSearchStats() const;
   const EngineConfig& getConfig() const;
 
+  // Live-Infos der Suche (UCI "info"); läuft im Such-Thread, leer = aus.
+  void setInfoCallback(std::function<void(const SearchInfo&)> cb);
+
+  // Apply new options to the live session. The TT is only reallocated when
+  // ttSizeMb actually changes; heuristics and cached evals are kept.
+  void setConfig(const EngineConfig& cfg);
+  // Forget everything learned so far (TT, eval/pawn caches, histories).
+  void newGame();
+
+  // Persist the TT (UCI: savehash / loadhash). loadHash maps the file as the new TT and
+  // adopts its size into ttSizeMb; on failure the current TT is kept.
+  bool saveHash(const std::string& path) const;
+  bool loadHash(const std::string& path);
+
+  // Page size actually backing the TT (hugetlb / THP / default)
+  std::size_t ttPageSize() const;
+  std::string ttPageDescription() const;
+
  private:
   struct Impl;
   Impl* pimpl;
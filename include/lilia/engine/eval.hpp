@@ -16,6 +16,9 @@ class Evaluator final {
   // Bewertung in cp aus Sicht der Seite am Zug.
   int evaluate(model::Position& pos) const;
 
+  // Cache-Zeilen für eine kommende evaluate() der Stellung (key, pawnKey) vorab laden.
+  void prefetch(std::uint64_t key, std::uint64_t pawnKey) const noexcept;
+
   // Eval- & Pawn-Caches leeren.
   void clearCaches() const noexcept;
 
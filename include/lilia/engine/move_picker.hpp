@@ -0,0 +1,259 @@
+#pragma once
+#include <climits>
+#include <cstdint>
+#include <utility>
+
+#include "lilia/engine/move_buffer.hpp"
+#include "lilia/model/move.hpp"
+#include "lilia/model/move_generator.hpp"
+#include "lilia/model/position.hpp"
+
+namespace lilia::engine {
+
+/**
+ * Gestaffelter Zuglieferant: erzeugt und bewertet Züge erst, wenn ihre Stufe erreicht ist.
+ * Die meisten Knoten schneiden am TT-Zug oder am ersten Schlag ab – Quiets werden dort nie
+ * generiert, geschweige denn sortiert.
+ *
+ * Stufen (Main):    TT-Zug → gute Schläge/Umwandlungen → Killer 1/2, Countermove → Quiets
+ *                   → schlechte Schläge
+ * Evasion:          TT-Zug → alle Evasions
+ * QSearch/ProbCut:  TT-Zug (nur Schlag/Umwandlung) → Schläge/Umwandlungen (ProbCut: nur gute)
+ *
+ * TT-Zug und Refutations werden per Position::resolveMove() ohne Generierung geprüft und später
+ * in ihren regulären Stufen übersprungen. next() liefert pseudolegale Züge (Legalität via
+ * doMove) und false, wenn nichts mehr kommt.
+ *
+ * Die SEE aller Schläge wird beim Generieren in einem Rutsch berechnet (Position::see_values);
+ * schlechte Schläge kommen nach SEE sortiert (am wenigsten verlierend zuerst), last_see() gibt
+ * den Wert des zuletzt gelieferten Zugs (für andere Züge erst auf Anfrage berechnet).
+ *
+ * Ordering liefert die Bewertung (Search-Histories etc.):
+ *   int  capture_score(const model::Move&) const          – Reihenfolge der Schläge
+ *   bool good_capture(const model::Move&, int see) const  – sonst ans Ende (Main) bzw. weg
+ *                                                           (ProbCut)
+ *   int  quiet_score(const model::Move&) const
+ *   int  evasion_score(const model::Move&) const
+ */
+template <class Ordering>
+class MovePicker {
+ public:
+  enum class Mode : std::uint8_t { Main, Evasion, QSearch, ProbCut };
+
+  // refutations: Killer 1, Killer 2, Countermove (nur Main; leere Slots werden übersprungen)
+  MovePicker(const model::Position& pos, model::MoveGenerator& mg, const Ordering& ord, Mode mode,
+             model::Move ttMove, const model::Move* refutations = nullptr)
+      : pos_(pos), mg_(mg), ord_(ord), mode_(mode) {
+    if (refutations)
+      for (int i = 0; i < 3; ++i) refs_[i] = refutations[i];
+
+    switch (mode) {
+      case Mode::Main:
+        stage_ = Stage::MainTT;
+        break;
+      case Mode::Evasion:
+        stage_ = Stage::EvasionTT;
+        break;
+      default:
+        stage_ = Stage::QTT;
+        break;
+    }
+
+    if (ttMove.from() != ttMove.to()) {
+      if (const auto full = pos.resolveMove(ttMove)) {
+        const bool noisy = full->isCapture() || full->promotion() != core::PieceType::None;
+        if (mode == Mode::Main || mode == Mode::Evasion || noisy) ttMove_ = *full;
+      }
+    }
+  }
+
+  bool next(model::Move& out) {
+    for (;;) {
+      switch (stage_) {
+        case Stage::MainTT:
+        case Stage::EvasionTT:
+        case Stage::QTT:
+          stage_ = static_cast<Stage>(static_cast<int>(stage_) + 1);
+          if (ttMove_.from() != ttMove_.to()) return yield(out, ttMove_, SEE_UNKNOWN);
+          break;
+
+        case Stage::CaptureInit:
+        case Stage::QCaptureInit: {
+          MoveBuffer buf(moves_, MAX_MOVES);
+          end_ = mg_.generateCapturesOnly(pos_.getBoard(), pos_.getState(), buf);
+          for (int i = 0; i < end_; ++i) scores_[i] = ord_.capture_score(moves_[i]);
+          pos_.see_values(moves_, end_, sees_);
+          cur_ = badEnd_ = 0;
+          stage_ = static_cast<Stage>(static_cast<int>(stage_) + 1);
+          break;
+        }
+
+        case Stage::GoodCaptures:
+          while (cur_ < end_) {
+            const model::Move m = pick_best();
+            const int see = sees_[cur_ - 1];
+            if (m == ttMove_) continue;
+            if (ord_.good_capture(m, see)) return yield(out, m, see);
+            // Slot ist schon verbraucht (badEnd_ < cur_)
+            moves_[badEnd_] = m;
+            sees_[badEnd_++] = see;
+          }
+          capEnd_ = end_;
+          stage_ = Stage::Refutations;
+          break;
+
+        case Stage::Refutations:
+          while (refIdx_ < 3) {
+            const model::Move r = refs_[refIdx_++];
+            if (r.from() == r.to() || r == ttMove_) continue;
+            bool dup = false;
+            for (int j = 0; j < refIdx_ - 1; ++j) dup |= (refs_[j] == r);
+            if (dup) continue;
+            // Nur Quiets: Schläge/Umwandlungen kamen schon in ihrer eigenen Stufe
+            const auto full = pos_.resolveMove(r);
+            if (!full || full->isCapture() || full->promotion() != core::PieceType::None) {
+              refs_[refIdx_ - 1] = model::Move{};  // in Quiets nicht mehr überspringen
+              continue;
+            }
+            return yield(out, *full, SEE_UNKNOWN);
+          }
+          stage_ = Stage::QuietInit;
+          break;
+
+        case Stage::QuietInit: {
+          MoveBuffer buf(moves_ + capEnd_, MAX_MOVES - capEnd_);
+          end_ = capEnd_ + mg_.generateQuietsOnly(pos_.getBoard(), pos_.getState(), buf);
+          cur_ = capEnd_;
+          for (int i = cur_; i < end_; ++i) {
+            scores_[i] = ord_.quiet_score(moves_[i]);
+            sees_[i] = SEE_UNKNOWN;
+          }
+          stage_ = Stage::Quiets;
+          break;
+        }
+
+        case Stage::Quiets:
+          while (cur_ < end_) {
+            const model::Move m = pick_best();
+            if (m == ttMove_ || m == refs_[0] || m == refs_[1] || m == refs_[2]) continue;
+            return yield(out, m, SEE_UNKNOWN);
+          }
+          cur_ = 0;
+          stage_ = Stage::BadCaptures;
+          break;
+
+        case Stage::BadCaptures:
+          if (cur_ < badEnd_) {
+            int best = cur_;
+            for (int i = cur_ + 1; i < badEnd_; ++i)
+              if (sees_[i] > sees_[best]) best = i;
+            std::swap(moves_[best], moves_[cur_]);
+            std::swap(sees_[best], sees_[cur_]);
+            ++cur_;
+            return yield(out, moves_[cur_ - 1], sees_[cur_ - 1]);
+          }
+          stage_ = Stage::Done;
+          break;
+
+        case Stage::EvasionInit: {
+          MoveBuffer buf(moves_, MAX_MOVES);
+          end_ = mg_.generateEvasions(pos_.getBoard(), pos_.getState(), buf);
+          for (int i = 0; i < end_; ++i) {
+            scores_[i] = ord_.evasion_score(moves_[i]);
+            sees_[i] = SEE_UNKNOWN;
+          }
+          cur_ = 0;
+          stage_ = Stage::Evasions;
+          break;
+        }
+
+        case Stage::Evasions:
+        case Stage::QCaptures:
+          while (cur_ < end_) {
+            const model::Move m = pick_best();
+            if (m == ttMove_) continue;
+            const int see = sees_[cur_ - 1];
+            if (mode_ == Mode::ProbCut && !ord_.good_capture(m, see)) continue;
+            return yield(out, m, see);
+          }
+          stage_ = Stage::Done;
+          break;
+
+        case Stage::Done:
+          return false;
+      }
+    }
+  }
+
+  // SEE des zuletzt von next() gelieferten Zugs (exakt, Quiets: was die Figur auf m.to() riskiert)
+  int last_see() {
+    if (lastSee_ == SEE_UNKNOWN) pos_.see_values(&last_, 1, &lastSee_);
+    return lastSee_;
+  }
+
+ private:
+  static constexpr int SEE_UNKNOWN = INT_MIN;
+
+  // Reihenfolge ist Teil der Logik: jede *TT-/Init-Stufe wird per +1 verlassen
+  enum class Stage : std::uint8_t {
+    MainTT,
+    CaptureInit,
+    GoodCaptures,
+    Refutations,
+    QuietInit,
+    Quiets,
+    BadCaptures,
+    EvasionTT,
+    EvasionInit,
+    Evasions,
+    QTT,
+    QCaptureInit,
+    QCaptures,
+    Done
+  };
+
+  bool yield(model::Move& out, const model::Move& m, int see) {
+    out = last_ = m;
+    lastSee_ = see;
+    return true;
+  }
+
+  // Partielle Selektion: nur so weit sortieren, wie tatsächlich gezogen wird
+  model::Move pick_best() {
+    int best = cur_;
+    for (int i = cur_ + 1; i < end_; ++i)
+      if (scores_[i] > scores_[best]) best = i;
+    const model::Move m = moves_[best];
+    const int s = scores_[best];
+    const int see = sees_[best];
+    moves_[best] = moves_[cur_];
+    scores_[best] = scores_[cur_];
+    sees_[best] = sees_[cur_];
+    moves_[cur_] = m;
+    scores_[cur_] = s;
+    sees_[cur_] = see;
+    ++cur_;
+    return m;
+  }
+
+  const model::Position& pos_;
+  model::MoveGenerator& mg_;
+  const Ordering& ord_;
+  Mode mode_;
+  Stage stage_ = Stage::Done;
+
+  model::Move ttMove_{};
+  model::Move refs_[3]{};
+  int refIdx_ = 0;
+
+  int cur_ = 0, end_ = 0;
+  int capEnd_ = 0;  // [0, capEnd_) Schläge, danach Quiets
+  int badEnd_ = 0;  // [0, badEnd_) zurückgestellte schlechte Schläge
+  model::Move moves_[MAX_MOVES];
+  int scores_[MAX_MOVES];
+  int sees_[MAX_MOVES];  // SEE_UNKNOWN für Quiets/Evasions, berechnet erst last_see()
+  model::Move last_{};
+  int lastSee_ = SEE_UNKNOWN;
+};
+
+}  // namespace lilia::engine
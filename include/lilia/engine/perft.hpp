@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "lilia/model/move.hpp"
+
+namespace lilia::model {
+class Position;
+}  // namespace lilia::model
+
+namespace lilia::engine {
+
+// Perft: zählt alle legalen Blätter bis depth. Die Root-Züge werden auf eigene Threads verteilt
+// (nicht den ThreadPool der Suche), Teilbäume über eine eigene Perft-Hash (Zobrist ^ Tiefe)
+// geteilt; der letzte Ply wird nicht ausgeführt, sondern nur gezählt (Bulk Counting).
+// hashMb == 0 schaltet die Hash ab. stop (z. B. UCI "stop") bricht ab, das Ergebnis ist dann
+// unvollständig (stopped).
+inline constexpr int PERFT_THREADS = 1;
+inline constexpr std::size_t PERFT_HASH_MB = 64;
+
+struct PerftResult {
+  std::uint64_t nodes = 0;
+  std::uint64_t elapsedMs = 0;
+  std::uint64_t nps = 0;
+  bool stopped = false;
+  // Divide: Knoten je legalem Root-Zug (Reihenfolge des Generators)
+  std::vector<std::pair<model::Move, std::uint64_t>> divide;
+};
+
+PerftResult run_perft(const model::Position& pos, int depth, int threads = PERFT_THREADS,
+                      std::size_t hashMb = PERFT_HASH_MB,
+                      const std::atomic<bool>* stop = nullptr);
+
+}  // namespace lilia::engine
@@ -36,10 +36,31 @@ static constexpr int PIECE_NB = 6;
 static constexpr int SQ_NB = 64;
 static constexpr int CH_LAYERS = 6;  // 1..6 ply wie bei SF
 
+// Knotentyp für die spezialisierte Suche (PV: volles Fenster, NonPV: Nullfenster)
+enum class NodeType : std::uint8_t { PV, NonPV };
+
 struct SearchStoppedException : public std::exception {
   const char* what() const noexcept override { return "Search stopped"; }
 };
 
+class TimeManager;
+
+// Harte Grenze einer Suche: Deadline des TimeManagers und/oder externes Abbruchsignal (UCI stop,
+// GUI). Jeder Such-Thread prüft sie selbst im seltenen Pfad der Knotenzählung (alle 1024 Knoten
+// ein steady_clock-Read) – kein Timer-Thread, Stop-Latenz = Zeit für 1024 Knoten + Abwickeln.
+// Die Deadline selbst kann sich während der Suche ändern (ponderhit).
+struct SearchDeadline {
+  const TimeManager* tm = nullptr;
+  const std::atomic<bool>* cancel = nullptr;
+};
+
+// Weitere Grenzen eines "go" neben der Zeit (UCI nodes / mate / searchmoves)
+struct SearchLimits {
+  std::uint64_t nodes = 0;               // > 0: Knotenlimit für die Summe aller Threads
+  int mate = 0;                          // > 0: aufhören, sobald ein Matt in <= mate Zügen steht
+  std::vector<model::Move> searchMoves;  // nicht leer: nur diese Wurzelzüge untersuchen
+};
+
 // -----------------------------------------------------------------------------
 // SearchStats – robustere Zähler (64-bit), schlanke Ausgabeinfos
 // -----------------------------------------------------------------------------
@@ -51,10 +72,31 @@ struct SearchStats {
   std::optional<model::Move> bestMove;
   std::vector<std::pair<model::Move, int>> topMoves;
   std::vector<model::Move> bestPV;
+  int hashfull = 0;     // Promille, UCI "info hashfull"
+  model::TTStats tt{};  // TT-Zähler dieser Suche (alle Threads)
 };
 
+// Zwischenstand für UCI "info": nach jeder fertigen Iteration, bzw. currmove-Updates an
+// langen Wurzeln (dann sind nur depth/currmove/currmoveNumber/nodes/timeMs gesetzt).
+struct SearchInfo {
+  int depth = 0;
+  int seldepth = 0;
+  int score = 0;  // Sicht der Seite am Zug, Mate-Scores wie intern (MATE - ply)
+  std::uint64_t nodes = 0;
+  std::uint64_t nps = 0;
+  std::uint64_t timeMs = 0;
+  int hashfull = 0;
+  int multipv = 1;
+  std::vector<model::Move> pv;
+  model::Move currmove{};
+  int currmoveNumber = 0;  // > 0: currmove-Update statt Iterationsergebnis
+};
+// Wird im Such-Thread (Main) aufgerufen – muss schnell zurückkehren.
+using InfoCallback = std::function<void(const SearchInfo&)>;
+
 // Vorwärtsdeklaration
 class Evaluator;
+class SearchThreads;
 
 // -----------------------------------------------------------------------------
 // Search – ein Instanz-pro-Thread (keine geteilten mutablen Daten)
@@ -70,13 +112,13 @@ class Search {
   Search(Search&&) = delete;
   Search& operator=(Search&&) = delete;
 
-  // Root (iterative deepening, parallel auf Root-Children)
-  // maxThreads <= 0 -> use cfg.threads for deterministic thread count
+  // Root (iterative deepening)
   int search_root_single(model::Position& pos, int maxDepth,
                          std::shared_ptr<std::atomic<bool>> stop, std::uint64_t maxNodes = 0);
 
+  // Lazy SMP: dieser Search ist der Main-Thread, helpers suchen parallel dieselbe Wurzel
   int search_root_lazy_smp(model::Position& pos, int maxDepth,
-                           std::shared_ptr<std::atomic<bool>> stop, int maxThreads,
+                           std::shared_ptr<std::atomic<bool>> stop, SearchThreads& helpers,
                            std::uint64_t maxNodes = 0);
   void set_node_limit(std::shared_ptr<std::atomic<std::uint64_t>> shared, std::uint64_t limit) {
     sharedNodes = std::move(shared);
@@ -87,6 +129,14 @@ class Search {
   void clearSearchState();  // Killers/History resetten
 
   model::TT5& ttRef() noexcept { return tt; }
+  // Nur der Main-Thread meldet; Helfer bekommen keinen Callback.
+  void set_info_callback(InfoCallback cb) { infoCb_ = std::move(cb); }
+  // Nur der Main-Thread fragt zwischen den Iterationen; nullptr = ohne Zeitsteuerung
+  void set_time_manager(TimeManager* tm) noexcept { timeMgr_ = tm; }
+  // Gilt für diese Search und (über search_root_lazy_smp) für alle Helfer
+  void set_deadline(const SearchDeadline& d) noexcept { deadline_ = d; }
+  // mate/searchMoves; das Knotenlimit läuft über maxNodes bzw. set_node_limit
+  void set_limits(const SearchLimits& l) { limits_ = l; }
 
   // Killers: 2 je Ply
   alignas(64) std::array<std::array<model::Move, 2>, MAX_PLY> killers{};
@@ -112,41 +162,29 @@ class Search {
 
  private:
   int thread_id_ = 0;  // 0 = main, >0 helpers
-  // Kernfunktionen
+  InfoCallback infoCb_;
+  TimeManager* timeMgr_ = nullptr;
+  SearchDeadline deadline_{};
+  SearchLimits limits_{};
+  int selDepth_ = 0;  // höchster erreichter Ply der laufenden Iteration
+  // Kernfunktionen – zur Compile-Zeit spezialisiert: NonPV-Knoten (Nullfenster, >95 % der
+  // Knoten) enthalten keine PV-Zweige und umgekehrt. Die Wurzel ist search_root_single().
+  // excludedMove (Singular-Verifikation) kommt nur in NonPV-Knoten vor.
+  template <NodeType NT>
   int negamax(model::Position& pos, int depth, int alpha, int beta, int ply, model::Move& refBest,
               int parentStaticEval = 0, const model::Move* excludedMove = nullptr);
-  int quiescence(model::Position& pos, int alpha, int beta, int ply);
+  // qply: plies already spent inside qsearch (quiet checks only at qply == 0)
+  template <bool InCheck>
+  int quiescence(model::Position& pos, int alpha, int beta, int ply, int qply = 0);
+  // Einstieg nach doMove(): Schachstatus kommt aus gaveCheck des gespielten Zugs
+  int quiescence_after_move(model::Position& pos, int alpha, int beta, int ply, int qply = 0);
   std::vector<model::Move> build_pv_from_tt(model::Position pos, int max_len = 16);
   int signed_eval(model::Position& pos);
-  // Copy global heuristics into this worker (killers are reset, on purpose)
-  void copy_heuristics_from(const Search& src);
-  // Merge this worker's heuristics into the global (killers are NOT merged)
-  void merge_from(const Search& other);
-
-  uint32_t tick_ = 0;
-  static constexpr uint32_t TICK_STEP = 1024;  // 256–2048 ist ok
-
-  inline void fast_tick() {
-    // billiger Hot-Path
-    ++tick_;
-    if ((tick_ & (TICK_STEP - 1)) != 0) return;
-
-    // seltener Slow-Path
-    if (sharedNodes) {
-      auto cur = sharedNodes->fetch_add(TICK_STEP, std::memory_order_relaxed) + TICK_STEP;
-      if (nodeLimit && cur >= nodeLimit) {
-        if (stopFlag) stopFlag->store(true, std::memory_order_relaxed);
-        throw SearchStoppedException();
-      }
-    }
-    if (stopFlag && stopFlag->load(std::memory_order_relaxed)) throw SearchStoppedException();
-  }
-
-  // optional: damit die letzten <TICK_STEP Restknoten noch gezählt werden
-  inline void flush_tick() {
-    if (!sharedNodes) return;
-    uint32_t rem = (tick_ & (TICK_STEP - 1));
-    if (rem) sharedNodes->fetch_add(rem, std::memory_order_relaxed);
+  // TT-Cluster und Eval/Pawn-Cache-Zeilen des Kindknotens laden, bevor doMove() läuft
+  inline void prefetch_child(const model::Position& pos, const model::Move& m) const noexcept {
+    const auto ck = pos.key_after(m);
+    tt.prefetch(ck.key);
+    eval_->prefetch(ck.key, ck.pawnKey);
   }
 
   // ---------------------------------------------------------------------------
@@ -164,9 +202,6 @@ class Search {
   model::Move genArr_[MAX_PLY][lilia::engine::MAX_MOVES];
   int genN_[MAX_PLY]{};
 
-  model::Move capArr_[MAX_PLY][lilia::engine::MAX_MOVES];
-  int capN_[MAX_PLY]{};
-
   // Stop/Stats
   std::shared_ptr<std::atomic<bool>> stopFlag;
   SearchStats stats;
@@ -0,0 +1,79 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../model/position.hpp"
+#include "../model/tt5.hpp"
+#include "config.hpp"
+
+namespace lilia::engine {
+
+class Search;
+class Evaluator;
+struct SearchDeadline;
+struct SearchLimits;
+
+// -----------------------------------------------------------------------------
+// SearchThreads – feste Helfer-Gruppe für Lazy SMP, gehört der Engine.
+// Jeder Helfer besitzt seinen Thread und seine Search (History, contHist, Puffer) für die
+// ganze Lebensdauer der Engine: pro Zug wird nichts allokiert, genullt oder kopiert, und die
+// Histories laufen zwischen den Zügen weiter. Der Main-Thread der Suche ist nicht Teil der
+// Gruppe – er sucht im Aufrufer-Thread.
+// -----------------------------------------------------------------------------
+class SearchThreads {
+ public:
+  SearchThreads(model::TT5& tt, std::shared_ptr<const Evaluator> eval, const EngineConfig& cfg);
+  ~SearchThreads();
+
+  SearchThreads(const SearchThreads&) = delete;
+  SearchThreads& operator=(const SearchThreads&) = delete;
+
+  // Anzahl Helfer setzen (Threads - 1). Nur zwischen zwei Suchen aufrufen.
+  void resize(int helpers);
+  int size() const noexcept { return static_cast<int>(workers_.size()); }
+
+  // Alle Helfer auf root losschicken; kehrt sofort zurück. Knoten laufen über nodes
+  // (gemeinsam mit dem Main-Thread), maxNodes gilt für die Summe; deadline prüft jeder Helfer
+  // selbst, limits.searchMoves schränkt auch die Wurzel der Helfer ein.
+  void start(const model::Position& root, int maxDepth, std::shared_ptr<std::atomic<bool>> stop,
+             std::shared_ptr<std::atomic<std::uint64_t>> nodes, std::uint64_t maxNodes,
+             const SearchDeadline& deadline, const SearchLimits& limits);
+  // Blockiert, bis jeder Helfer seine Suche beendet hat (stop muss gesetzt sein).
+  void wait();
+
+  // newGame: Histories/Killers aller Helfer zurücksetzen
+  void clear();
+
+ private:
+  struct Worker {
+    std::unique_ptr<Search> search;
+    std::thread thread;
+  };
+
+  void idle_loop(Search& s, std::uint64_t seen);
+  void shutdown();
+
+  model::TT5& tt_;
+  std::shared_ptr<const Evaluator> eval_;
+  const EngineConfig& cfg_;
+  std::vector<Worker> workers_;
+
+  // Auftrag der aktuellen Runde; nur geschrieben, während alle Helfer warten
+  model::Position root_;
+  int maxDepth_ = 0;
+  std::shared_ptr<std::atomic<bool>> stop_;
+
+  std::mutex m_;
+  std::condition_variable startCv_;
+  std::condition_variable doneCv_;
+  std::uint64_t round_ = 0;  // jede Runde startet alle Helfer genau einmal
+  int running_ = 0;
+  bool quit_ = false;
+};
+
+}  // namespace lilia::engine
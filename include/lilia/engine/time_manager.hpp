@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "../model/move.hpp"
+
+namespace lilia::engine {
+
+// Zeitvorgaben eines "go", aus Sicht der Seite am Zug (alles in ms)
+struct TimeLimits {
+  int timeLeft = -1;  // < 0: keine Uhr
+  int inc = 0;
+  int movestogo = 0;  // 0: Sudden Death
+  int movetime = -1;  // > 0: feste Zeit pro Zug
+  int moveOverhead = 10;
+  bool infinite = false;  // go infinite: nur "stop" beendet die Suche
+  bool ponder = false;    // go ponder: Grenzen gelten erst ab ponderhit()
+};
+
+// -----------------------------------------------------------------------------
+// TimeManager – Soll- (optimum) und Maximalzeit eines Zugs.
+// maximum() ist die harte Grenze; ob schon nach optimum() aufgehört wird, entscheidet
+// stop_after_iteration() nach jeder fertigen Iteration anhand von
+//   - Stabilität des besten Zugs (Wechsel klingen pro Iteration ab),
+//   - Score-Trend (fallender Score -> mehr Zeit),
+//   - Knotenanteil des besten Root-Zugs (eindeutiger Zug -> weniger Zeit).
+// Bei movetime sind beide Grenzen gleich, die Heuristiken greifen dann nicht.
+// Beim Pondern ist die Deadline offen, bis ponderhit() sie setzt; die Soll-Zeit zählt ab dem
+// "go ponder", die schon gerechnete Zeit wird also angerechnet.
+// -----------------------------------------------------------------------------
+class TimeManager {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  // Startet die Uhr des Zugs und berechnet die Grenzen
+  void start(const TimeLimits& limits);
+
+  bool managed() const noexcept { return managed_; }  // false: ohne Zeitlimit
+  std::int64_t optimum() const noexcept { return optimum_; }
+  std::int64_t maximum() const noexcept { return maximum_; }
+  // Harte Grenze der Suche; time_point::max() solange offen (ohne Limit oder beim Pondern)
+  clock::time_point deadline() const noexcept {
+    return clock::time_point(clock::duration(deadline_.load(std::memory_order_relaxed)));
+  }
+  // Von jedem Such-Thread im seltenen Pfad der Knotenzählung
+  bool past_deadline() const noexcept {
+    const auto at = deadline_.load(std::memory_order_relaxed);
+    return at != NO_DEADLINE && clock::now().time_since_epoch().count() >= at;
+  }
+  bool pondering() const noexcept { return pondering_.load(); }
+  // UCI-Thread: aus dem Pondern wird eine Suche mit Uhr. Hätte die Suche schon aufgehört,
+  // läuft die Deadline sofort ab, sonst maximum() ab jetzt (ab jetzt läuft unsere Uhr).
+  void ponderhit();
+  std::int64_t elapsed() const noexcept {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - t0_).count();
+  }
+
+  // Nur vom Main-Thread nach jeder fertigen Iteration; true = jetzt aufhören.
+  // bestNodeFraction: Anteil der Root-Knoten dieser Iteration unter dem besten Zug (0..1)
+  bool stop_after_iteration(const model::Move& best, int score, double bestNodeFraction);
+
+ private:
+  void arm_deadline(clock::time_point from);
+
+  static constexpr clock::rep NO_DEADLINE = clock::duration::max().count();
+
+  clock::time_point t0_{};
+  std::atomic<clock::rep> deadline_{NO_DEADLINE};
+  std::atomic<bool> pondering_{false};
+  std::atomic<bool> stopOnPonderhit_{false};
+  bool managed_ = false;
+  bool fixed_ = false;  // movetime: optimum == maximum
+  std::int64_t optimum_ = 0;
+  std::int64_t maximum_ = 0;
+
+  model::Move prevBest_{};
+  double bestMoveChanges_ = 0.0;
+  bool haveScore_ = false;
+  double scoreAvg_ = 0.0;
+};
+
+}  // namespace lilia::engine
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace lilia::log {
+
+// -----------------------------------------------------------------------------
+// MpscRing – begrenzte lock-freie Queue (Vyukov) für viele Produzenten und genau einen
+// Konsumenten. Produzenten reservieren einen Platz per CAS und geben ihn über die
+// Sequenznummer der Zelle frei; voll = try_push() liefert false, niemand wartet.
+// -----------------------------------------------------------------------------
+class MpscRing {
+ public:
+  explicit MpscRing(std::size_t capacity);  // wird auf eine Zweierpotenz aufgerundet
+
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  bool try_push(std::string& text);  // bei Erfolg wird text verschoben
+  bool try_pop(std::string& out);    // nur der Konsument
+  // Belegte Plätze, nur eine Momentaufnahme (Produzenten und Konsument laufen weiter)
+  std::size_t approx_size() const noexcept {
+    return head_.load(std::memory_order_relaxed) - tail_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> seq{0};
+    std::string text;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  std::size_t mask_ = 0;
+  alignas(64) std::atomic<std::size_t> head_{0};  // nächster Schreibplatz (Produzenten)
+  alignas(64) std::atomic<std::size_t> tail_{0};  // nächster Leseplatz (Konsument)
+};
+
+// -----------------------------------------------------------------------------
+// Channel – die beiden Ausgabekanäle des Prozesses und ihr einziger Writer-Thread:
+//   protocol: UCI-Protokoll -> stdout, geht nie verloren (bei vollem Ring: yield); nur für den
+//             UCI-Thread (bestmove, readyok, ...),
+//   info:     "info"-Zeilen der Such-Threads in denselben Ring, aber nie blockierend: ab
+//             INFO_LIMIT belegten Plätzen (liest die GUI nicht mit) werden sie verworfen und
+//             gezählt; der Rest des Rings bleibt für protocol frei,
+//   diagnostic: Logzeilen -> stderr, werden bei vollem Ring verworfen und gezählt.
+// Aufrufer formatieren nur und reihen ein; I/O macht der Writer.
+// -----------------------------------------------------------------------------
+class Channel {
+ public:
+  static Channel& instance();
+
+  void protocol(std::string text);
+  void info(std::string text);
+  void diagnostic(std::string text);
+  // Blockiert, bis alles bisher Eingereihte geschrieben ist (vor quit / Programmende).
+  void flush();
+  std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+  std::uint64_t info_dropped() const noexcept {
+    return infoDropped_.load(std::memory_order_relaxed);
+  }
+
+  Channel(const Channel&) = delete;
+  Channel& operator=(const Channel&) = delete;
+
+ private:
+  Channel();
+  ~Channel();
+  void wake();
+  void writer_loop();
+
+  static constexpr std::size_t RING_SIZE = 4096;
+  static constexpr std::size_t INFO_LIMIT = RING_SIZE / 2;
+
+  MpscRing protocol_{RING_SIZE};
+  MpscRing diagnostic_{RING_SIZE};
+  std::atomic<std::uint64_t> pushed_{0};
+  std::atomic<std::uint64_t> written_{0};  // vom Writer ausgegeben, für flush()
+  std::atomic<std::uint64_t> dropped_{0};
+  std::atomic<std::uint64_t> infoDropped_{0};
+  std::atomic<std::uint32_t> wakeups_{0};
+  std::atomic<bool> sleeping_{false};
+  std::atomic<bool> quit_{false};
+  std::thread writer_;
+};
+
+// -----------------------------------------------------------------------------
+// Level und Kategorien – zur Laufzeit umschaltbar (UCI: "Log Level", "Log Categories").
+// enabled() ist ein relaxed Load je Atomic, also auch im Such-Thread billig.
+// -----------------------------------------------------------------------------
+enum class Level : std::uint8_t { Off, Error, Warn, Info, Debug };
+
+enum class Category : std::uint32_t {
+  General = 1u << 0,
+  Search = 1u << 1,
+  Uci = 1u << 2,
+  TT = 1u << 3,
+  Time = 1u << 4,
+};
+inline constexpr std::uint32_t ALL_CATEGORIES = 0x1fu;
+
+namespace detail {
+inline std::atomic<Level> g_level{Level::Warn};
+inline std::atomic<std::uint32_t> g_categories{ALL_CATEGORIES};
+}  // namespace detail
+
+inline bool enabled(Level lv, Category cat) noexcept {
+  return lv <= detail::g_level.load(std::memory_order_relaxed) &&
+         (detail::g_categories.load(std::memory_order_relaxed) &
+          static_cast<std::uint32_t>(cat)) != 0;
+}
+inline void set_level(Level lv) noexcept {
+  detail::g_level.store(lv, std::memory_order_relaxed);
+}
+inline void set_categories(std::uint32_t mask) noexcept {
+  detail::g_categories.store(mask, std::memory_order_relaxed);
+}
+
+// Zeilenweise in den diagnostic-Kanal schreibender ostream (je Thread einer), für Fortschritt
+// von Werkzeugen wie bench, die einen std::ostream* erwarten
+std::ostream& diagnostic();
+
+// "off|error|warn|info|debug" bzw. "all" oder Liste wie "search,uci"; false = unbekannt
+bool parse_level(std::string_view s, Level& out);
+bool parse_categories(std::string_view s, std::uint32_t& out);
+const char* level_name(Level lv);
+const char* category_name(Category cat);
+
+// Eine Logzeile: sammelt per operator<< und reiht sie am Ende des Ausdrucks ein.
+// Nur über LILIA_LOG benutzen, dann wird bei abgeschaltetem Level nichts formatiert.
+class Line {
+ public:
+  Line(Level lv, Category cat);
+  Line(const Line&) = delete;
+  Line& operator=(const Line&) = delete;
+  ~Line();
+
+  template <class T>
+  Line& operator<<(const T& v) {
+    os_ << v;
+    return *this;
+  }
+
+ private:
+  std::ostringstream os_;
+};
+
+}  // namespace lilia::log
+
+// Eine vollständige Anweisung (Schleife mit höchstens einem Durchlauf statt if/else), damit
+// LILIA_LOG auch ohne Klammern in einem if mit eigenem else steht
+#define LILIA_LOG(level, category)                                                 \
+  for (bool lilia_on_ = ::lilia::log::enabled(::lilia::log::Level::level,          \
+                                             ::lilia::log::Category::category);    \
+       lilia_on_; lilia_on_ = false)                                               \
+  ::lilia::log::Line(::lilia::log::Level::level, ::lilia::log::Category::category)
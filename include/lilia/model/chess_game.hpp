@@ -41,7 +41,6 @@ class ChessGame {
   MoveGenerator m_move_gen;
   Position m_position;
   core::GameResult m_result;
-  std::vector<Move> m_pseudo_moves;
   std::vector<Move> m_legal_moves;
 };
 
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <bit>
 #include <cassert>
 #include <iostream>
@@ -103,4 +104,48 @@ constexpr inline Bitboard black_pawn_attacks(Bitboard pawns) {
   return (sw(pawns) | se(pawns));
 }
 
+// ---------------- Linien-Tabellen ----------------
+// between(a, b): Felder strikt zwischen a und b; line(a, b): ganze Gerade durch a und b (bis zum
+// Rand, inkl. a und b). Beide 0, wenn a und b auf keiner gemeinsamen Linie liegen.
+namespace detail {
+
+constexpr std::array<std::array<Bitboard, 64>, 64> build_line_table(bool fullLine) {
+  std::array<std::array<Bitboard, 64>, 64> T{};
+  for (int a = 0; a < 64; ++a)
+    for (int b = 0; b < 64; ++b) {
+      if (a == b) continue;
+      const int df = (b & 7) - (a & 7), dr = (b >> 3) - (a >> 3);
+      if (df != 0 && dr != 0 && df != dr && df != -dr) continue;
+      const int sf = (df > 0) - (df < 0), sr = (dr > 0) - (dr < 0);
+      Bitboard mask = 0;
+      if (fullLine) {
+        int f = a & 7, r = a >> 3;
+        while (f - sf >= 0 && f - sf < 8 && r - sr >= 0 && r - sr < 8) f -= sf, r -= sr;
+        for (; f >= 0 && f < 8 && r >= 0 && r < 8; f += sf, r += sr)
+          mask |= Bitboard{1} << (r * 8 + f);
+      } else {
+        for (int f = (a & 7) + sf, r = (a >> 3) + sr; r * 8 + f != b; f += sf, r += sr)
+          mask |= Bitboard{1} << (r * 8 + f);
+      }
+      T[a][b] = mask;
+    }
+  return T;
+}
+
+}  // namespace detail
+
+inline constexpr auto BETWEEN = detail::build_line_table(false);
+inline constexpr auto LINE = detail::build_line_table(true);
+
+constexpr inline Bitboard between(core::Square a, core::Square b) {
+  return BETWEEN[a][b];
+}
+constexpr inline Bitboard line(core::Square a, core::Square b) {
+  return LINE[a][b];
+}
+// a, b und c auf einer Geraden
+constexpr inline bool aligned(core::Square a, core::Square b, core::Square c) {
+  return (line(a, b) & sq_bb(c)) != 0;
+}
+
 }  // namespace lilia::model::bb
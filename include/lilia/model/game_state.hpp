@@ -1,6 +1,7 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
-#include <vector>
+#include <type_traits>
 
 #include "core/bitboard.hpp"     // for bb::Bitboard, bb::Castling flags
 #include "core/model_types.hpp"  // for core::Color, core::Square, etc.
@@ -18,6 +19,17 @@ struct GameState {
   core::Square enPassantSquare = core::NO_SQUARE;
 };
 
+// Schach-Lage einer Stellung, je doMove einmal berechnet (Position::checkInfo()).
+// blockers[c]: einzige Figur (beider Farben) zwischen König c und einem gegnerischen Slider,
+// pinners[c]: gegnerische Slider, die so eine eigene Figur von c fesseln,
+// checkSquares[pt]: Felder, von denen eine Figur der Seite am Zug dem Gegnerkönig Schach gibt.
+struct CheckInfo {
+  bb::Bitboard checkers{0};
+  bb::Bitboard blockers[2]{};
+  bb::Bitboard pinners[2]{};
+  bb::Bitboard checkSquares[6]{};
+};
+
 struct StateInfo {
   Move move{};                        // last move
   bb::Bitboard prevPawnKey{};         // pawn hash before move
@@ -27,21 +39,91 @@ struct StateInfo {
   std::uint8_t gaveCheck{0};          // 0/1
   std::uint8_t prevCastlingRights{};  // castling rights before move
   core::Square prevEnPassantSquare{core::NO_SQUARE};
+  CheckInfo prevCheck{};              // check info before move
 };
 
 struct NullState {
   bb::Bitboard zobristKey{0};  // full hash before null move
+  CheckInfo prevCheck{};
   std::uint16_t prevHalfmoveClock{0};
+  std::uint16_t prevPliesFromNull{0};
+  std::int16_t prevRepetition{0};
   std::uint32_t prevFullmoveNumber{1};
   std::uint8_t prevCastlingRights{0};
   core::Square prevEnPassantSquare{core::NO_SQUARE};
 };
 
+// Ein Eintrag des Wiederholungs-Rings: Hash einer früheren Stellung und ihr Wiederholungsstand –
+// Abstand in Halbzügen zum letzten gleichen Vorgänger (innerhalb von halfmoveClock, ohne Nullzug
+// dazwischen), negativ, wenn der selbst schon eine Wiederholung war; 0 = neu.
+// 16 Byte, vier je Cache-Line – die Suche nach gleichen Keys läuft über dichte Daten.
+struct RepEntry {
+  bb::Bitboard key{0};
+  std::int16_t repetition{0};
+};
+
+// -----------------------------------------------------------------------------
+// StateStack – fester Ring für den Make/Unmake-Zustand, ohne Heap-Allokation.
+// Läuft er über (sehr lange Partie), fallen die ältesten Einträge heraus: zurückgenommen wird nur
+// der Suchpfad, und Wiederholungen reichen nie weiter als halfmoveClock zurück.
+// Kopien übernehmen nur die gültigen Einträge (copy_tail auch nur ein Ende davon).
+// -----------------------------------------------------------------------------
+template <class T, int N>
+class StateStack {
+  static_assert((N & (N - 1)) == 0, "StateStack size must be a power of two");
+  static_assert(std::is_trivially_copyable_v<T>, "StateStack holds POD states only");
+
+ public:
+  StateStack() = default;
+  StateStack(const StateStack& o) { copy_tail(o, o.count_); }
+  StateStack& operator=(const StateStack& o) {
+    if (this != &o) copy_tail(o, o.count_);
+    return *this;
+  }
+
+  bool empty() const noexcept { return count_ == 0; }
+  int size() const noexcept { return count_; }
+  void clear() noexcept { top_ = 0, count_ = 0; }
+
+  void push(const T& v) noexcept {
+    slots_.v[top_++ & MASK] = v;
+    if (count_ < N) ++count_;
+  }
+  void pop() noexcept { --top_, --count_; }
+  const T& back() const noexcept { return slots_.v[(top_ - 1) & MASK]; }
+  // i-ter Eintrag von oben (0 == back()), i < size()
+  const T& from_top(int i) const noexcept { return slots_.v[(top_ - 1 - (unsigned)i) & MASK]; }
+
+  // Nur die obersten n Einträge von o übernehmen
+  void copy_tail(const StateStack& o, int n) noexcept {
+    n = std::clamp(n, 0, o.count_);
+    for (int i = 0; i < n; ++i) slots_.v[i] = o.slots_.v[(o.top_ - (unsigned)(n - i)) & MASK];
+    top_ = (unsigned)n;
+    count_ = n;
+  }
+
+ private:
+  static constexpr unsigned MASK = N - 1;
+  // bewusst uninitialisiert: gelesen wird nur, was vorher per push/copy_tail geschrieben wurde
+  union Slots {
+    Slots() {}
+    T v[N];
+  };
+  alignas(64) Slots slots_;
+  unsigned top_ = 0;  // Anzahl Pushes - Pops (läuft modulo N im Ring)
+  int count_ = 0;     // davon noch gültig, <= N
+};
+
+// Partie-Ende für Wiederholungen (<= 100 Halbzüge) plus Suchpfad und PV-Aufbau
+inline constexpr int STATE_STACK_SIZE = 256;
+inline constexpr int NULL_STACK_SIZE = 128;
+
 // Sanity checks (cheap, catch accidental changes early)
 static_assert(sizeof(GameState) >= 16, "GameState too small?");
 static_assert((bb::Castling::WK | bb::Castling::WQ | bb::Castling::BK | bb::Castling::BQ) <= 0xF,
               "Castling rights must fit in 4 bits");
 static_assert(std::is_trivially_copyable_v<StateInfo>, "StateInfo should be POD");
 static_assert(std::is_trivially_copyable_v<NullState>, "NullState should be POD");
+static_assert(sizeof(RepEntry) == 16, "RepEntry should stay at 16 bytes");
 
 }  // namespace lilia::model
@@ -19,7 +19,7 @@ class MoveGenerator {
   void generateCapturesOnly(const Board& b, const GameState& st, std::vector<Move>& out) const;
 
   // Evasions bei Schach: sichere Königszüge plus (bei Single-Check) Checker schlagen / blocken
-  // Pseudolegal – finale Legalität via doMove()
+  // Fesselungen und EP-Aufdeckung sind berücksichtigt, die Züge sind legal
   void generateEvasions(const Board& b, const GameState& st, std::vector<Move>& out) const;
   void generateNonCapturePromotions(const Board& b, const GameState& st,
                                     std::vector<model::Move>& out) const;
@@ -27,8 +27,17 @@ class MoveGenerator {
   // Return: Anzahl generierter Züge
   int generatePseudoLegalMoves(const Board&, const GameState&, engine::MoveBuffer& buf);
   int generateCapturesOnly(const Board&, const GameState&, engine::MoveBuffer& buf);
+  // Komplement zu generateCapturesOnly: keine Schläge, keine Umwandlungen (inkl. Rochade)
+  int generateQuietsOnly(const Board&, const GameState&, engine::MoveBuffer& buf);
   int generateEvasions(const Board&, const GameState&, engine::MoveBuffer& buf);
   int generateNonCapturePromotions(const Board& b, const GameState& st, engine::MoveBuffer& buf);
+
+  // Voll legal: wie oben, im Schach aber über die Evasions. Ergebnis darf per
+  // Position::doMoveLegal() ohne erneuten Königstest ausgeführt werden.
+  void generateLegalMoves(const Board& b, const GameState& st, std::vector<Move>& out) const;
+  int generateLegalMoves(const Board&, const GameState&, engine::MoveBuffer& buf);
+  int generateLegalCaptures(const Board&, const GameState&, engine::MoveBuffer& buf);
+  int generateLegalQuiets(const Board&, const GameState&, engine::MoveBuffer& buf);
 };
 
 }  // namespace lilia::model
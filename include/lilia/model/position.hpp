@@ -1,6 +1,6 @@
 #pragma once
 #include <cstdint>
-#include <vector>
+#include <optional>
 
 #include "../engine/eval_acc.hpp"
 #include "board.hpp"
@@ -13,6 +13,11 @@ namespace lilia::model {
 class Position {
  public:
   Position() = default;
+  // Kopien (Such-Snapshots, Helfer-Threads) übernehmen nur das Ende der Historie, das
+  // Wiederholungen und lastMoveGaveCheck() brauchen; Züge vor der Kopie lassen sich dort nicht
+  // zurücknehmen.
+  Position(const Position& o);
+  Position& operator=(const Position& o);
 
   Board& getBoard() { return m_board; }
   const Board& getBoard() const { return m_board; }
@@ -46,8 +51,19 @@ class Position {
     m_state.pawnKey = pk;
   }
 
+  // Zobrist- und pawnKey der Stellung nach m, ohne den Zug auszuführen (für Prefetch vor
+  // doMove). Für legale Züge identisch mit hash()/pawnKey nach doMove(m).
+  struct ChildKeys {
+    std::uint64_t key;
+    std::uint64_t pawnKey;
+  };
+  [[nodiscard]] ChildKeys key_after(const Move& m) const noexcept;
+
   // Make/Unmake
   bool doMove(const Move& m);
+  // Vertrauenswürdiger Pfad für Züge aus MoveGenerator::generateLegal*: keine Validierung,
+  // kein Königstest nach dem Zug. Mit pseudolegalen Zügen undefiniert.
+  void doMoveLegal(const Move& m);
   void undoMove();
   bool doNullMove();
   void undoNullMove();
@@ -55,14 +71,41 @@ class Position {
   // Statusabfragen
   bool checkInsufficientMaterial();
   bool checkMoveRule();
-  bool checkRepetition();
-
-  bool inCheck() const;
+  // Dreifache Wiederholung; O(1), gezählt wird schon in doMove() über den Key-Ring
+  bool checkRepetition() const noexcept { return m_repetition < 0; }
+  // Remis für die Suche: dreifach, oder zweifach mit dem Vorgänger innerhalb der letzten ply
+  // Halbzüge (also hinter der Wurzel)
+  bool checkRepetition(int ply) const noexcept {
+    return m_repetition != 0 && m_repetition < ply;
+  }
+  // Kann die Seite am Zug mit einem reversiblen Zug eine frühere Stellung wiederherstellen
+  // (Cuckoo-Tabellen)? Liegt diese innerhalb der Suche (weniger als ply Halbzüge zurück),
+  // reicht das als Remis, davor muss sie selbst schon eine Wiederholung gewesen sein.
+  bool upcomingRepetition(int ply) const noexcept;
+
+  bool inCheck() const { return m_check.checkers != 0; }
+  // Schach-Lage der Stellung am Zug (Schachgeber, Fesselungen, Schachfelder)
+  const CheckInfo& checkInfo() const noexcept { return m_check; }
+  // Gibt der pseudolegale Zug m Schach? Direkt, abgezogen, per Umwandlung, EP oder Rochade.
+  bool givesCheck(const Move& m) const;
+  // Nach Brett-/State-Setup von außen (FEN) neu aufbauen; doMove/undoMove pflegen sie selbst
+  void buildCheckInfo();
   /// Static exchange evaluation. Simulates the capture sequence on the
-  /// destination square (also for quiet moves) and returns true if the net
-  /// material gain is non-negative.
+  /// destination square and returns true if the net material gain is
+  /// non-negative; quiet moves always pass.
   bool see(const model::Move& m) const;
+  /// Threshold SEE: true if the exchange on m.to() nets at least threshold.
+  /// Quiet moves risk the moving piece, so see_ge(quiet, -x) bounds how much
+  /// a move to an attacked square may hang.
+  bool see_ge(const model::Move& m, int threshold) const;
+  /// Exact SEE values for n moves at once (e.g. all captures of a node);
+  /// attackers per target square are computed once and shared.
+  void see_values(const model::Move* moves, int n, int* out) const;
   bool isPseudoLegal(const Move& m) const;
+  // Zug nur aus from/to/promo (TT, Killer, UCI) → Flags wie vom Generator gesetzt, falls er hier
+  // pseudolegal ist. Eine Umwandlung ist genau dann Pflicht, wenn ein Bauer die letzte Reihe
+  // erreicht.
+  std::optional<Move> resolveMove(const Move& m) const;
 
   const engine::EvalAcc& getEvalAcc() const noexcept { return evalAcc_; }
   void rebuildEvalAcc() { evalAcc_.build_from_board(m_board); }
@@ -70,14 +113,23 @@ class Position {
  private:
   Board m_board;
   GameState m_state;
-  std::vector<StateInfo> m_history;
+  StateStack<StateInfo, STATE_STACK_SIZE> m_history;
   bb::Bitboard m_hash = 0;
+  CheckInfo m_check;
   engine::EvalAcc evalAcc_;
-  std::vector<NullState> m_null_history;
+  StateStack<NullState, NULL_STACK_SIZE> m_null_history;
+  // Keys der Stellungen vor jedem Zug, parallel zu m_history, aber dicht gepackt
+  StateStack<RepEntry, STATE_STACK_SIZE> m_keys;
+  std::uint16_t m_pliesFromNull = 0;
+  std::int16_t m_repetition = 0;  // wie RepEntry::repetition, für die aktuelle Stellung
 
   // interne Helfer
+  StateInfo saveState(const Move& m) const;
+  void buildCheckers();
   void applyMove(const Move& m, StateInfo& st);
   void unapplyMove(const StateInfo& st);
+  void pushRepetitionKey();
+  bool see_start(const Move& m, int& gain, core::PieceType& onTo, bb::Bitboard& occ) const;
 
   // Zobrist/PawnKey inkrementell
   inline void hashXorPiece(core::Color c, core::PieceType pt, core::Square s) {
@@ -95,19 +147,20 @@ class Position {
   // EP-Hash nur dann xoren, wenn EP in der aktuellen State-Kombination relevant ist.
   // Wichtig: Vor State-Änderungen aufrufen, um "alt" aus dem Hash zu entfernen,
   // und NACH allen State-Änderungen erneut, um "neu" zu addieren.
-  void xorEPRelevant() {
-    const auto ep = m_state.enPassantSquare;
-    if (ep == core::NO_SQUARE) return;
+  void xorEPRelevant() { m_hash ^= epHashFor(m_state.enPassantSquare, m_state.sideToMove); }
+
+  // EP-Anteil am Hash für (ep, stm) auf dem aktuellen Brett, 0 wenn nicht relevant
+  bb::Bitboard epHashFor(core::Square ep, core::Color stm) const {
+    if (ep == core::NO_SQUARE) return 0;
 
-    const auto stm = m_state.sideToMove;
     const bb::Bitboard pawnsSTM = m_board.getPieces(stm, core::PieceType::Pawn);
-    if (!pawnsSTM) return;  // nichts zu tun
+    if (!pawnsSTM) return 0;  // nichts zu tun
 
     const int epIdx = static_cast<int>(ep);
     const int file = epIdx & 7;
     const int ci = bb::ci(stm);
 
-    if (pawnsSTM & Zobrist::epCaptureMask[ci][epIdx]) m_hash ^= Zobrist::epFile[file];
+    return (pawnsSTM & Zobrist::epCaptureMask[ci][epIdx]) ? Zobrist::epFile[file] : 0;
   }
 };
 
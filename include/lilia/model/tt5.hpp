@@ -4,11 +4,21 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <new>
 #include <optional>
+#include <string>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 #include "move.hpp"  // expects lilia::model::Move etc.
+#include "tt_memory.hpp"
 
 namespace lilia::model {
 
@@ -43,12 +53,128 @@ struct TTEntry5 {
 #endif
 
 #ifndef TT5_INDEX_MIX
-// 0: use low bits of Zobrist (klassisch), 1: simple mixer (xor-shift)
+// 0: Zobrist direkt (rotiert), 1: simple mixer (xor-shift); beide per multiply-shift indiziert
 #define TT5_INDEX_MIX 1
 #endif
 
+#ifndef TT5_LAYOUT
+// Entry layout + replacement policy of model::TT5 (see TTLayoutPacked4 / TTLayoutCompact6)
+#define TT5_LAYOUT TTLayoutPacked4
+#endif
+
+#ifndef TT5_STATS
+// 1: per-thread sharded probe/store counters (BasicTT5::stats); off by default, the
+// tt_bench/tt_replay targets (and the tests) switch them on
+#define TT5_STATS 0
+#endif
+
+#ifndef TT5_RECORD
+// 1: every TT probe/store is reported to tt_recorder (tools only, e.g. tt_replay)
+#define TT5_RECORD 0
+#endif
+
 // -----------------------------------------------------------------------------
-// Internal packed entry & cluster
+// Move packing (16 bit), shared by all layouts
+// -----------------------------------------------------------------------------
+namespace tt_detail {
+
+inline std::uint16_t promo_to3(core::PieceType p) noexcept {
+  switch (p) {
+    case core::PieceType::Knight:
+      return 1;
+    case core::PieceType::Bishop:
+      return 2;
+    case core::PieceType::Rook:
+      return 3;
+    case core::PieceType::Queen:
+      return 4;
+    default:
+      return 0;
+  }
+}
+inline core::PieceType promo_from3(uint16_t v) noexcept {
+  switch (v & 0x7) {
+    case 1:
+      return core::PieceType::Knight;
+    case 2:
+      return core::PieceType::Bishop;
+    case 3:
+      return core::PieceType::Rook;
+    case 4:
+      return core::PieceType::Queen;
+    default:
+      return core::PieceType::None;
+  }
+}
+inline std::uint16_t pack_move16(const Move& m) noexcept {
+  const uint16_t from = (unsigned)m.from() & 0x3F;
+  const uint16_t to = (unsigned)m.to() & 0x3F;
+  const uint16_t pr3 = promo_to3(m.promotion()) & 0x7;
+  const uint16_t cap = m.isCapture() ? 1u : 0u;
+  return (uint16_t)(from | (to << 6) | (pr3 << 12) | (cap << 15));
+}
+inline Move unpack_move16(std::uint16_t v) noexcept {
+  Move m{};
+  m.set_from(static_cast<core::Square>(v & 0x3F));
+  m.set_to(static_cast<core::Square>((v >> 6) & 0x3F));
+  m.set_promotion(promo_from3((v >> 12) & 0x7));
+  m.set_capture(((v >> 15) & 1u) != 0);
+  m.set_enpassant(false);
+  m.set_castle(CastleSide::None);
+  return m;
+}
+
+}  // namespace tt_detail
+
+// -----------------------------------------------------------------------------
+// Probe/store outcomes as reported by the layouts (feed the TT5_STATS counters)
+// -----------------------------------------------------------------------------
+enum class TTProbeResult : std::uint8_t {
+  Miss = 0,
+  Hit = 1,
+  KeyMismatch = 2,  // miss, but an entry agreed on keyLow16 (a collision the key check caught)
+  Count
+};
+
+enum class TTStoreResult : std::uint8_t {
+  Empty = 0,           // written into a free slot
+  SameKey = 1,         // existing entry of the same position updated
+  ReplaceStale = 2,    // other position from an older search evicted
+  ReplaceShallow = 3,  // other position from this search evicted (lower priority)
+  Rejected = 4,        // dropped: kept entry was better or a concurrent writer won
+  Count
+};
+
+// Summed counters of one table; see BasicTT5::stats().
+struct TTStats {
+  std::uint64_t probes = 0;
+  std::uint64_t hits = 0;
+  std::uint64_t keyMismatches = 0;
+  std::uint64_t stores = 0;
+  std::uint64_t emptyWrites = 0;
+  std::uint64_t sameKeyWrites = 0;
+  std::uint64_t replacedStale = 0;
+  std::uint64_t replacedShallow = 0;
+  std::uint64_t rejected = 0;
+
+  double hit_rate() const noexcept { return probes ? double(hits) / double(probes) : 0.0; }
+  double collision_rate() const noexcept {
+    return probes ? double(keyMismatches) / double(probes) : 0.0;
+  }
+};
+
+// -----------------------------------------------------------------------------
+// Entry layouts. A layout owns the 64-byte Cluster and decides how entries are
+// packed, verified and replaced:
+//   static constexpr const char* kName;  static constexpr int kEntries;
+//   struct Cluster;                      (alignas(64), value-init == empty)
+//   static TTProbeResult probe(const Cluster&, key, curAge, TTEntry5& out) noexcept;
+//   static TTStoreResult store(Cluster&, key, age, depth8, bound, mv16, v16, se16) noexcept;
+//   static int count_current(const Cluster&, curAge) noexcept;  (entries of this search)
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+// TTLayoutPacked4: 4 x 16 bytes (two atomics each), CAS-published.
 // info bit layout (low -> high):
 //  [ 0..15] keyLow16
 //  [16..23] age8
@@ -71,55 +197,27 @@ struct TTEntryPacked {
   TTEntryPacked& operator=(const TTEntryPacked&) = delete;
 };
 
-struct alignas(64) Cluster {
-  std::array<TTEntryPacked, 4> e{};
-  Cluster() = default;
-  Cluster(const Cluster&) = delete;
-  Cluster& operator=(const Cluster&) = delete;
-};
+struct TTLayoutPacked4 {
+  static constexpr const char* kName = "packed4";
+  static constexpr int kEntries = 4;
 
-// -----------------------------------------------------------------------------
-// TT5
-// -----------------------------------------------------------------------------
-class TT5 {
- public:
-  explicit TT5(std::size_t mb = 16) { resize(mb); }
+  struct alignas(64) Cluster {
+    std::array<TTEntryPacked, kEntries> e{};
+    Cluster() = default;
+    Cluster(const Cluster&) = delete;
+    Cluster& operator=(const Cluster&) = delete;
+  };
 
-  void resize(std::size_t mb) {
-    const auto bytes = std::max<std::size_t>(mb, 1) * 1024ull * 1024ull;
-    const auto want = bytes / sizeof(Cluster);
-    // round down to power of two to keep mask indexing
-    slots_ = highest_pow2(want ? want : 1);
-    table_.reset(new Cluster[slots_]);
-    generation_.store(1u, std::memory_order_relaxed);
-    // (optional) std::fprintf(stderr,"TT: %.1f MB real\n", slots_*sizeof(Cluster)/1048576.0);
-  }
-
-  void clear() {
-    const auto n = slots_;
-    table_.reset();
-    table_ = std::unique_ptr<Cluster[]>(new Cluster[n]);
-    generation_.store(1u, std::memory_order_relaxed);
-  }
-
-  inline void new_generation() noexcept {
-    auto g = generation_.fetch_add(1u, std::memory_order_relaxed) + 1u;
-    if (g == 0u) generation_.store(1u, std::memory_order_relaxed);
-  }
-
-  inline void prefetch(std::uint64_t key) const noexcept { LILIA_PREFETCH_L1(&table_[index(key)]); }
-
-  // --- Probe into user entry ---
-  bool probe_into(std::uint64_t key, TTEntry5& out) const noexcept {
-    const Cluster& c = table_[index(key)];
-    LILIA_PREFETCH_L1(&c);
-    for (int i = 0; i < 4; i++) {
+  static TTProbeResult probe(const Cluster& c, std::uint64_t key, std::uint8_t cur,
+                             TTEntry5& out) noexcept {
+    for (int i = 0; i < kEntries; i++) {
       LILIA_PREFETCH_L1(&c.e[i].info);
       LILIA_PREFETCH_L1(&c.e[i].data);
     }
 
     const std::uint16_t keyLo = static_cast<std::uint16_t>(key);
     const std::uint16_t keyHi = static_cast<std::uint16_t>(key >> 48);
+    bool mismatch = false;
 
     for (const auto& ent : c.e) {
       std::uint64_t info1 = ent.info.load(std::memory_order_acquire);
@@ -133,13 +231,19 @@ class TT5 {
       // key high fast-reject (from info)
       const std::uint16_t infoKeyHi =
           static_cast<std::uint16_t>((info1 >> INFO_KEYHI_SHIFT) & 0xFFFFu);
-      if (LILIA_UNLIKELY(infoKeyHi != keyHi)) continue;
+      if (LILIA_UNLIKELY(infoKeyHi != keyHi)) {
+        mismatch = true;
+        continue;
+      }
 
       // Ok: read data relaxed
       const std::uint64_t d = ent.data.load(std::memory_order_relaxed);
       // Torn-read/ABA-Schutz: verifiziere KeyHigh auch aus den Daten
       const std::uint16_t dKeyHi = static_cast<std::uint16_t>(d >> 48);
-      if (LILIA_UNLIKELY(dKeyHi != keyHi)) continue;
+      if (LILIA_UNLIKELY(dKeyHi != keyHi)) {
+        mismatch = true;
+        continue;
+      }
 
       TTEntry5 tmp{};
       tmp.key = key;
@@ -148,14 +252,13 @@ class TT5 {
       tmp.bound = static_cast<Bound>((info1 >> INFO_BOUND_SHIFT) & 0x3u);
 
       const std::uint16_t mv16 = static_cast<std::uint16_t>(d & 0xFFFFu);
-      tmp.best = unpack_move16(mv16);
+      tmp.best = tt_detail::unpack_move16(mv16);
       tmp.value = static_cast<int16_t>((d >> 16) & 0xFFFFu);
       tmp.staticEval = static_cast<int16_t>((d >> 32) & 0xFFFFu);
 
       out = tmp;
 
       // refresh age if stale (best-effort)
-      uint8_t cur = (uint8_t)generation_.load(std::memory_order_relaxed);
       uint8_t entAge = (uint8_t)((info1 >> INFO_AGE_SHIFT) & 0xFFu);
       if ((uint8_t)(cur - entAge) > 8) {
         uint64_t newInfo =
@@ -163,36 +266,30 @@ class TT5 {
         auto& infoAtomic = const_cast<std::atomic<uint64_t>&>(ent.info);
         (void)infoAtomic.compare_exchange_strong(info1, newInfo, std::memory_order_relaxed);
       }
-      return true;
+      return TTProbeResult::Hit;
     }
 
-    return false;
+    return mismatch ? TTProbeResult::KeyMismatch : TTProbeResult::Miss;
   }
 
-  std::optional<TTEntry5> probe(std::uint64_t key) const {
-    TTEntry5 tmp{};
-    if (probe_into(key, tmp)) return tmp;
-    return std::nullopt;
+  static int count_current(const Cluster& c, std::uint8_t cur) noexcept {
+    int n = 0;
+    for (const auto& ent : c.e) {
+      const std::uint64_t info = ent.info.load(std::memory_order_relaxed);
+      n += (info & INFO_VALID_MASK) != 0ull &&
+           static_cast<std::uint8_t>((info >> INFO_AGE_SHIFT) & 0xFFu) == cur;
+    }
+    return n;
   }
+
 #ifndef TT_DETERMINISTIC
   // --- LIGHT DETERMINISTIC, LOW-OVERHEAD STORE ---
-  void store(std::uint64_t key, int32_t value, int16_t depth, Bound bound, const Move& best,
-             int16_t staticEval = std::numeric_limits<int16_t>::min()) noexcept {
-    Cluster& c = table_[index(key)];
-    LILIA_PREFETCHW_L1(&c);
-
-    const std::uint8_t age = static_cast<std::uint8_t>(generation_.load(std::memory_order_relaxed));
+  static TTStoreResult store(Cluster& c, std::uint64_t key, std::uint8_t age, std::uint8_t depth8,
+                             Bound bound, std::uint16_t mv16, std::int16_t v16,
+                             std::int16_t se16) noexcept {
     const std::uint16_t keyLo = static_cast<std::uint16_t>(key);
     const std::uint16_t keyHi = static_cast<std::uint16_t>(key >> 48);
 
-    const std::uint8_t depth8 =
-        static_cast<std::uint8_t>(depth < 0 ? 0 : (depth > 255 ? 255 : depth));
-    const std::int16_t v16 = static_cast<std::int16_t>(std::clamp(
-        value, (int)std::numeric_limits<int16_t>::min(), (int)std::numeric_limits<int16_t>::max()));
-    const std::int16_t se16 = static_cast<std::int16_t>(std::clamp(
-        staticEval, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()));
-    const std::uint16_t mv16 = pack_move16(best);
-
     auto bound_strength = [](Bound b) -> int {
       return b == Bound::Exact ? 2 : (b == Bound::Lower ? 1 : 0);
     };
@@ -253,16 +350,16 @@ class TT5 {
           (void)ent.data.compare_exchange_strong(oldData, patched, std::memory_order_relaxed,
                                                  std::memory_order_relaxed);
         }
-        return;
+        return TTStoreResult::Rejected;
       }
 
       ent.data.store(newData, std::memory_order_relaxed);
       for (int tries = 0; tries < 2; ++tries) {
         if (ent.info.compare_exchange_strong(oldInfo, newInfo, std::memory_order_release,
                                              std::memory_order_acquire))
-          break;
+          return TTStoreResult::SameKey;
       }
-      return;  // regardless of CAS success, don’t loop — avoid stalls
+      return TTStoreResult::Rejected;  // regardless of CAS success, don’t loop — avoid stalls
     }
 
     // 2) Free slot: one CAS
@@ -271,13 +368,13 @@ class TT5 {
       ent.data.store(newData, std::memory_order_relaxed);
       if (ent.info.compare_exchange_strong(expected, newInfo, std::memory_order_release,
                                            std::memory_order_relaxed))
-        return;
+        return TTStoreResult::Empty;
     }
 
     // 3) Replacement: pick victim by your heuristic; replace only if strictly better; one CAS try
     int victim = 0;
     int bestScore = repl_score(c.e[0], age);
-    for (int i = 1; i < 4; ++i) {
+    for (int i = 1; i < kEntries; ++i) {
       const int sc = repl_score(c.e[i], age);
       if (sc < bestScore) {
         bestScore = sc;
@@ -287,34 +384,21 @@ class TT5 {
 
     auto& ent = c.e[victim];
     std::uint64_t oldInfo = ent.info.load(std::memory_order_acquire);
-    if (!strictly_better(oldInfo)) return;
+    if (!strictly_better(oldInfo)) return TTStoreResult::Rejected;
 
     ent.data.store(newData, std::memory_order_relaxed);
-    (void)ent.info.compare_exchange_strong(oldInfo, newInfo, std::memory_order_release,
-                                           std::memory_order_acquire);
-    // if CAS fails, we just drop it — cheap and deterministic enough
+    if (!ent.info.compare_exchange_strong(oldInfo, newInfo, std::memory_order_release,
+                                          std::memory_order_acquire))
+      return TTStoreResult::Rejected;  // CAS lost: just drop it — cheap and deterministic enough
+    return info_age(oldInfo) != age ? TTStoreResult::ReplaceStale : TTStoreResult::ReplaceShallow;
   }
 #else
-  void store(std::uint64_t key, int32_t value, int16_t depth, Bound bound, const Move& best,
-             int16_t staticEval = std::numeric_limits<int16_t>::min()) noexcept {
-    Cluster& c = table_[index(key)];
-    LILIA_PREFETCHW_L1(&c);
-
-    const std::uint8_t curAge =
-        static_cast<std::uint8_t>(generation_.load(std::memory_order_relaxed));
+  static TTStoreResult store(Cluster& c, std::uint64_t key, std::uint8_t curAge,
+                             std::uint8_t depth8, Bound bound, std::uint16_t mv16,
+                             std::int16_t v16, std::int16_t se16) noexcept {
     const std::uint16_t keyLo = static_cast<std::uint16_t>(key);
     const std::uint16_t keyHi = static_cast<std::uint16_t>(key >> 48);
 
-    const std::uint8_t depth8 =
-        static_cast<std::uint8_t>(depth < 0 ? 0 : (depth > 255 ? 255 : depth));
-    const std::int16_t v16 = static_cast<std::int16_t>(
-        value < std::numeric_limits<int16_t>::min()   ? std::numeric_limits<int16_t>::min()
-        : value > std::numeric_limits<int16_t>::max() ? std::numeric_limits<int16_t>::max()
-                                                      : value);
-    const std::int16_t se16 = static_cast<std::int16_t>(std::clamp(
-        staticEval, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()));
-    const std::uint16_t mv16 = pack_move16(best);
-
     auto bound_strength = [](Bound b) constexpr -> int {
       return b == Bound::Exact ? 2 : (b == Bound::Lower ? 1 : 0);
     };
@@ -365,13 +449,13 @@ class TT5 {
 
       // If the existing entry is "better or equal", keep it.
       const uint32_t oldQ = info_quality(oldInfo);
-      if (oldQ > newQ) return;
+      if (oldQ > newQ) return TTStoreResult::Rejected;
 
       // Otherwise, attempt to replace deterministically.
       ent.data.store(newData, std::memory_order_relaxed);
       if (ent.info.compare_exchange_strong(oldInfo, newInfoTemplate, std::memory_order_release,
                                            std::memory_order_acquire)) {
-        return;
+        return TTStoreResult::SameKey;
       }
       // CAS failed -> someone else updated; restart same-key loop.
       // We could loop a few times, but a single restart of the outer loop suffices.
@@ -384,14 +468,14 @@ class TT5 {
       ent.data.store(newData, std::memory_order_relaxed);
       if (ent.info.compare_exchange_strong(expected, newInfoTemplate, std::memory_order_release,
                                            std::memory_order_relaxed)) {
-        return;
+        return TTStoreResult::Empty;
       }
     }
 
     // 3) Replacement: choose victim by your heuristic, but guard with quality CAS
     int victim = 0;
     int bestScore = repl_score(c.e[0], curAge);
-    for (int i = 1; i < 4; ++i) {
+    for (int i = 1; i < kEntries; ++i) {
       const int sc = repl_score(c.e[i], curAge);
       if (sc < bestScore) {
         bestScore = sc;
@@ -404,16 +488,19 @@ class TT5 {
     for (int tries = 0; tries < 4; ++tries) {
       std::uint64_t oldInfo = ent.info.load(std::memory_order_acquire);
       const uint32_t oldQ = info_quality(oldInfo);
-      if (oldQ > newQ) return;  // Victim is actually stronger — keep it (deterministic).
+      // Victim is actually stronger — keep it (deterministic).
+      if (oldQ > newQ) return TTStoreResult::Rejected;
 
       ent.data.store(newData, std::memory_order_relaxed);
       if (ent.info.compare_exchange_strong(oldInfo, newInfoTemplate, std::memory_order_release,
                                            std::memory_order_acquire)) {
-        return;
+        const auto oldAge = static_cast<std::uint8_t>((oldInfo >> INFO_AGE_SHIFT) & 0xFFu);
+        return oldAge != curAge ? TTStoreResult::ReplaceStale : TTStoreResult::ReplaceShallow;
       }
       // someone else changed the victim; retry a couple times
     }
     // Give up silently if contention is extreme.
+    return TTStoreResult::Rejected;
   }
 #endif
 
@@ -426,53 +513,6 @@ class TT5 {
   static constexpr unsigned INFO_KEYHI_SHIFT = 34;
   static constexpr std::uint64_t INFO_VALID_MASK = (1ull << 63);
 
-  // --- move packing (16 bit) ---
-  static inline std::uint16_t promo_to3(core::PieceType p) noexcept {
-    switch (p) {
-      case core::PieceType::Knight:
-        return 1;
-      case core::PieceType::Bishop:
-        return 2;
-      case core::PieceType::Rook:
-        return 3;
-      case core::PieceType::Queen:
-        return 4;
-      default:
-        return 0;
-    }
-  }
-  static inline core::PieceType promo_from3(uint16_t v) noexcept {
-    switch (v & 0x7) {
-      case 1:
-        return core::PieceType::Knight;
-      case 2:
-        return core::PieceType::Bishop;
-      case 3:
-        return core::PieceType::Rook;
-      case 4:
-        return core::PieceType::Queen;
-      default:
-        return core::PieceType::None;
-    }
-  }
-  static inline std::uint16_t pack_move16(const Move& m) noexcept {
-    const uint16_t from = (unsigned)m.from() & 0x3F;
-    const uint16_t to = (unsigned)m.to() & 0x3F;
-    const uint16_t pr3 = promo_to3(m.promotion()) & 0x7;
-    const uint16_t cap = m.isCapture() ? 1u : 0u;
-    return (uint16_t)(from | (to << 6) | (pr3 << 12) | (cap << 15));
-  }
-  static inline Move unpack_move16(std::uint16_t v) noexcept {
-    Move m{};
-    m.set_from(static_cast<core::Square>(v & 0x3F));
-    m.set_to(static_cast<core::Square>((v >> 6) & 0x3F));
-    m.set_promotion(promo_from3((v >> 12) & 0x7));
-    m.set_capture(((v >> 15) & 1u) != 0);
-    m.set_enpassant(false);
-    m.set_castle(CastleSide::None);
-    return m;
-  }
-
   // --- replacement score: lower is worse (chosen as victim) ---
   static inline int repl_score(const TTEntryPacked& ent, std::uint8_t curAge) noexcept {
     const std::uint64_t info = ent.info.load(std::memory_order_relaxed);
@@ -495,29 +535,410 @@ class TT5 {
     // mateBias = isMate;
     return (int)dep * 512 + boundBias + mateBias - (ageDelta * 2);
   }
+};
 
-  static inline void write_entry(TTEntryPacked& ent, std::uint16_t keyLo, std::uint16_t keyHi,
-                                 std::uint8_t age, std::uint8_t depth8, Bound bound,
-                                 std::uint16_t mv16, std::int16_t v16, std::int16_t se16) noexcept {
-    const std::uint64_t newData =
-        (static_cast<std::uint64_t>(mv16) & 0xFFFFull) |
-        (static_cast<std::uint64_t>(static_cast<std::uint16_t>(v16)) << 16) |
-        (static_cast<std::uint64_t>(static_cast<std::uint16_t>(se16)) << 32) |
-        (static_cast<std::uint64_t>(keyHi) << 48);
+// -----------------------------------------------------------------------------
+// TTLayoutCompact6: 6 x 10 bytes (+4 pad) per cache line, one lockless write.
+// Fields are written with plain relaxed stores in a single pass, no CAS. The key
+// field holds keyLow16 XOR all other fields, so an entry torn by two concurrent
+// writers (or a half-done write) fails verification and reads as a miss.
+//  genBound8: [7..3] gen5 (age mod 32) | [2] VALID | [1..0] bound2
+// Replacement: same key if deeper/exact/stale, else always the slot with the
+// lowest depth - 8 * relativeAge.
+// -----------------------------------------------------------------------------
+struct TTEntryCompact {
+  std::atomic<std::uint16_t> check{0};  // keyLow16 ^ move ^ value ^ eval ^ (depth | genBound<<8)
+  std::atomic<std::uint16_t> move{0};
+  std::atomic<std::uint16_t> value{0};
+  std::atomic<std::uint16_t> eval{0};
+  std::atomic<std::uint8_t> depth{0};
+  std::atomic<std::uint8_t> genBound{0};
+  TTEntryCompact() = default;
+  TTEntryCompact(const TTEntryCompact&) = delete;
+  TTEntryCompact& operator=(const TTEntryCompact&) = delete;
+};
+static_assert(sizeof(TTEntryCompact) == 10, "compact TT entry must stay 10 bytes");
+
+struct TTLayoutCompact6 {
+  static constexpr const char* kName = "compact6";
+  static constexpr int kEntries = 6;
+
+  struct alignas(64) Cluster {
+    std::array<TTEntryCompact, kEntries> e{};
+    Cluster() = default;
+    Cluster(const Cluster&) = delete;
+    Cluster& operator=(const Cluster&) = delete;
+  };
+  static_assert(sizeof(Cluster) == 64, "compact TT cluster must fill one cache line");
+
+  // Only keyLow16 is stored, so a colliding key cannot be told apart from a torn or
+  // foreign entry: misses are never reported as KeyMismatch.
+  static TTProbeResult probe(const Cluster& c, std::uint64_t key, std::uint8_t cur,
+                             TTEntry5& out) noexcept {
+    const std::uint16_t keyLo = static_cast<std::uint16_t>(key);
+    const std::uint8_t cur5 = static_cast<std::uint8_t>(cur & GEN_MASK5);
 
-    const std::uint64_t newInfo =
-        INFO_VALID_MASK | (static_cast<std::uint64_t>(keyLo)) |
-        (static_cast<std::uint64_t>(age) << INFO_AGE_SHIFT) |
-        (static_cast<std::uint64_t>(depth8) << INFO_DEPTH_SHIFT) |
-        (static_cast<std::uint64_t>(static_cast<std::uint8_t>(bound)) << INFO_BOUND_SHIFT) |
-        (static_cast<std::uint64_t>(keyHi) << INFO_KEYHI_SHIFT);
+    for (const auto& ent : c.e) {
+      const std::uint8_t gb = ent.genBound.load(std::memory_order_relaxed);
+      if (LILIA_UNLIKELY((gb & GB_VALID) == 0)) continue;
+      const std::uint16_t mv = ent.move.load(std::memory_order_relaxed);
+      const std::uint16_t v = ent.value.load(std::memory_order_relaxed);
+      const std::uint16_t se = ent.eval.load(std::memory_order_relaxed);
+      const std::uint8_t dep = ent.depth.load(std::memory_order_relaxed);
+      const std::uint16_t chk = ent.check.load(std::memory_order_relaxed);
+      if (LILIA_UNLIKELY(static_cast<std::uint16_t>(chk ^ fold(mv, v, se, dep, gb)) != keyLo))
+        continue;
+
+      const std::uint8_t rel = static_cast<std::uint8_t>((cur5 - (gb >> GB_GEN_SHIFT)) & GEN_MASK5);
 
-    ent.data.store(newData, std::memory_order_relaxed);
-    ent.info.store(newInfo, std::memory_order_release);
+      TTEntry5 tmp{};
+      tmp.key = key;
+      tmp.age = static_cast<std::uint8_t>(cur - rel);
+      tmp.depth = dep;
+      tmp.bound = static_cast<Bound>(gb & GB_BOUND_MASK);
+      tmp.best = tt_detail::unpack_move16(mv);
+      tmp.value = static_cast<int16_t>(v);
+      tmp.staticEval = static_cast<int16_t>(se);
+      out = tmp;
+
+      // refresh age if stale (best-effort; a racing writer just turns it into a miss)
+      if (rel > 8) {
+        const std::uint8_t ngb =
+            static_cast<std::uint8_t>((gb & ~GB_GEN_MASK) | (cur5 << GB_GEN_SHIFT));
+        auto& e = const_cast<TTEntryCompact&>(ent);
+        e.genBound.store(ngb, std::memory_order_relaxed);
+        e.check.store(static_cast<std::uint16_t>(keyLo ^ fold(mv, v, se, dep, ngb)),
+                      std::memory_order_relaxed);
+      }
+      return TTProbeResult::Hit;
+    }
+    return TTProbeResult::Miss;
+  }
+
+  static int count_current(const Cluster& c, std::uint8_t cur) noexcept {
+    const std::uint8_t want =
+        static_cast<std::uint8_t>(((cur & GEN_MASK5) << GB_GEN_SHIFT) | GB_VALID);
+    int n = 0;
+    for (const auto& ent : c.e)
+      n += (ent.genBound.load(std::memory_order_relaxed) & (GB_GEN_MASK | GB_VALID)) == want;
+    return n;
+  }
+
+  static TTStoreResult store(Cluster& c, std::uint64_t key, std::uint8_t age, std::uint8_t depth8,
+                             Bound bound, std::uint16_t mv16, std::int16_t v16,
+                             std::int16_t se16) noexcept {
+    const std::uint16_t keyLo = static_cast<std::uint16_t>(key);
+    const std::uint8_t cur5 = static_cast<std::uint8_t>(age & GEN_MASK5);
+
+    TTEntryCompact* target = nullptr;
+    int bestScore = std::numeric_limits<int>::max();
+    int targetRel = 0;
+    for (auto& ent : c.e) {
+      const std::uint8_t gb = ent.genBound.load(std::memory_order_relaxed);
+      if ((gb & GB_VALID) == 0) {  // empty → take it, unless the key sits further on
+        if (bestScore != std::numeric_limits<int>::min()) {
+          target = &ent;
+          bestScore = std::numeric_limits<int>::min();
+        }
+        continue;
+      }
+      const std::uint16_t mv = ent.move.load(std::memory_order_relaxed);
+      const std::uint16_t v = ent.value.load(std::memory_order_relaxed);
+      const std::uint16_t se = ent.eval.load(std::memory_order_relaxed);
+      const std::uint8_t dep = ent.depth.load(std::memory_order_relaxed);
+      const std::uint16_t chk = ent.check.load(std::memory_order_relaxed);
+      const std::uint8_t gen5 = static_cast<std::uint8_t>(gb >> GB_GEN_SHIFT);
+
+      if (static_cast<std::uint16_t>(chk ^ fold(mv, v, se, dep, gb)) == keyLo) {
+        // same position: keep a deeper entry of this search unless we bring an exact bound
+        if (bound != Bound::Exact && depth8 + 4 <= dep && gen5 == cur5)
+          return TTStoreResult::Rejected;
+        if (mv16 == 0) mv16 = mv;  // don't lose the best move to a move-less store
+        write(ent, keyLo, cur5, depth8, bound, mv16, v16, se16);
+        return TTStoreResult::SameKey;
+      }
+
+      const int rel = (cur5 - gen5) & GEN_MASK5;
+      const int sc = int(dep) - 8 * rel;
+      if (sc < bestScore) {
+        bestScore = sc;
+        target = &ent;
+        targetRel = rel;
+      }
+    }
+    write(*target, keyLo, cur5, depth8, bound, mv16, v16, se16);
+    if (bestScore == std::numeric_limits<int>::min()) return TTStoreResult::Empty;
+    return targetRel ? TTStoreResult::ReplaceStale : TTStoreResult::ReplaceShallow;
+  }
+
+ private:
+  static constexpr std::uint8_t GEN_MASK5 = 0x1F;
+  static constexpr unsigned GB_GEN_SHIFT = 3;
+  static constexpr std::uint8_t GB_GEN_MASK = 0xF8;
+  static constexpr std::uint8_t GB_VALID = 0x04;
+  static constexpr std::uint8_t GB_BOUND_MASK = 0x03;
+
+  static inline std::uint16_t fold(std::uint16_t mv, std::uint16_t v, std::uint16_t se,
+                                   std::uint8_t dep, std::uint8_t gb) noexcept {
+    return static_cast<std::uint16_t>(mv ^ v ^ se ^ (std::uint16_t(dep) | (std::uint16_t(gb) << 8)));
+  }
+
+  static inline void write(TTEntryCompact& ent, std::uint16_t keyLo, std::uint8_t gen5,
+                           std::uint8_t depth8, Bound bound, std::uint16_t mv16, std::int16_t v16,
+                           std::int16_t se16) noexcept {
+    const std::uint8_t gb = static_cast<std::uint8_t>((gen5 << GB_GEN_SHIFT) | GB_VALID |
+                                                      static_cast<std::uint8_t>(bound));
+    const std::uint16_t v = static_cast<std::uint16_t>(v16);
+    const std::uint16_t se = static_cast<std::uint16_t>(se16);
+    ent.check.store(static_cast<std::uint16_t>(keyLo ^ fold(mv16, v, se, depth8, gb)),
+                    std::memory_order_relaxed);
+    ent.move.store(mv16, std::memory_order_relaxed);
+    ent.value.store(v, std::memory_order_relaxed);
+    ent.eval.store(se, std::memory_order_relaxed);
+    ent.depth.store(depth8, std::memory_order_relaxed);
+    ent.genBound.store(gb, std::memory_order_relaxed);
+  }
+};
+
+#if TT5_RECORD
+// Observes every probe/store/new_generation of every TT (single-threaded recording only).
+struct TTRecorder {
+  virtual ~TTRecorder() = default;
+  virtual void on_probe(std::uint64_t key, bool hit) = 0;
+  virtual void on_store(std::uint64_t key, int32_t value, int16_t depth, Bound bound,
+                        std::uint16_t move16, int16_t staticEval) = 0;
+  virtual void on_new_generation() = 0;
+};
+inline TTRecorder* tt_recorder = nullptr;
+#endif
+
+// -----------------------------------------------------------------------------
+// On-disk format of BasicTT5::save/load (native byte order). The header is padded
+// to TT_FILE_HEADER_BYTES so the cluster array that follows can be mapped as is.
+// -----------------------------------------------------------------------------
+inline constexpr char TT_FILE_MAGIC[8] = {'L', 'I', 'L', 'I', 'A', 'T', 'T', '\0'};
+inline constexpr std::uint32_t TT_FILE_VERSION = 1;
+inline constexpr std::size_t TT_FILE_HEADER_BYTES = 4096;
+
+struct TTFileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t headerBytes;
+  std::uint64_t clusters;
+  std::uint32_t clusterBytes;
+  std::uint32_t entries;     // per cluster
+  std::uint32_t generation;  // at save time
+  std::uint32_t indexMix;    // TT5_INDEX_MIX – index() must match to find anything
+  char layout[16];
+};
+static_assert(sizeof(TTFileHeader) <= TT_FILE_HEADER_BYTES);
+
+// -----------------------------------------------------------------------------
+// BasicTT5: allocation, indexing and aging; entry format comes from Layout
+// -----------------------------------------------------------------------------
+template <class Layout>
+class BasicTT5 {
+ public:
+  using Cluster = typename Layout::Cluster;
+  static_assert(alignof(Cluster) == 64 && sizeof(Cluster) == 64,
+                "TT layouts must use one cache line per cluster");
+
+  // Runs fn(i) for every i in [0, n). The engine passes its worker pool here so the
+  // table is zeroed (and first-touched) by several threads instead of the caller alone.
+  using ParallelFor =
+      std::function<void(std::size_t n, const std::function<void(std::size_t)>& fn)>;
+
+  explicit BasicTT5(std::size_t mb = 16, bool largePages = true) : largePages_(largePages) {
+    resize(mb);
+  }
+
+  void resize(std::size_t mb, const ParallelFor& pf = {}) {
+    const auto bytes = std::max<std::size_t>(mb, 1) * 1024ull * 1024ull;
+    const auto want = bytes / sizeof(Cluster);
+    // any cluster count: index() maps via multiply-shift, no pow2 rounding needed
+    slots_ = want ? want : 1;
+    table_ = static_cast<Cluster*>(mem_.allocate(slots_ * sizeof(Cluster), largePages_));
+    if (!table_) throw std::bad_alloc();
+    init_clusters(pf);
+    generation_.store(1u, std::memory_order_relaxed);
+    // (optional) std::fprintf(stderr,"TT: %.1f MB real\n", slots_*sizeof(Cluster)/1048576.0);
+  }
+
+  // Zeroes the table in place (no reallocation).
+  void clear(const ParallelFor& pf = {}) {
+    init_clusters(pf);
+    generation_.store(1u, std::memory_order_relaxed);
+  }
+
+  // Writes header + cluster array. Only call while no search is running.
+  bool save(const std::string& path) const {
+    TTFileHeader h = make_header();
+    h.clusters = slots_;
+    h.generation = generation_.load(std::memory_order_relaxed);
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return false;
+    char pad[TT_FILE_HEADER_BYTES] = {};
+    std::memcpy(pad, &h, sizeof(h));
+    out.write(pad, sizeof(pad));
+    out.write(reinterpret_cast<const char*>(table_), std::streamsize(size_bytes()));
+    return bool(out.flush());
+  }
+
+  // Maps a file written by save() as the new table (copy-on-write, pages are read
+  // lazily). The table takes the file's size; on any mismatch the current table is
+  // kept and false is returned. The saved generation becomes the current one, so the
+  // entries of the last saved search count as fresh and older ones keep their distance.
+  bool load(const std::string& path) {
+    TTFileHeader h{};
+    {
+      std::ifstream in(path, std::ios::binary);
+      if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) return false;
+    }
+    const TTFileHeader want = make_header();
+    if (std::memcmp(h.magic, want.magic, sizeof(h.magic)) != 0 || h.version != want.version ||
+        h.headerBytes != want.headerBytes || h.clusterBytes != want.clusterBytes ||
+        h.entries != want.entries || h.indexMix != want.indexMix ||
+        std::memcmp(h.layout, want.layout, sizeof(h.layout)) != 0 || h.clusters == 0)
+      return false;
+
+    void* p = mem_.map_file(path.c_str(), TT_FILE_HEADER_BYTES,
+                            static_cast<std::size_t>(h.clusters) * sizeof(Cluster));
+    if (!p) return false;
+    table_ = static_cast<Cluster*>(p);
+    slots_ = static_cast<std::size_t>(h.clusters);
+    generation_.store(h.generation ? h.generation : 1u, std::memory_order_relaxed);
+    return true;
+  }
+
+  std::size_t slots() const noexcept { return slots_; }
+  std::size_t size_bytes() const noexcept { return slots_ * sizeof(Cluster); }
+  static constexpr const char* layout_name() noexcept { return Layout::kName; }
+  static constexpr int entries_per_cluster() noexcept { return Layout::kEntries; }
+
+  // Takes effect on the next resize().
+  void set_large_pages(bool on) noexcept { largePages_ = on; }
+  bool large_pages() const noexcept { return largePages_; }
+  std::size_t page_size() const noexcept { return mem_.page_size(); }
+  const char* page_description() const noexcept { return mem_.page_description(); }
+
+  inline void new_generation() noexcept {
+#if TT5_RECORD
+    if (tt_recorder) tt_recorder->on_new_generation();
+#endif
+    auto g = generation_.fetch_add(1u, std::memory_order_relaxed) + 1u;
+    if (g == 0u) generation_.store(1u, std::memory_order_relaxed);
+  }
+
+  inline void prefetch(std::uint64_t key) const noexcept { LILIA_PREFETCH_L1(&table_[index(key)]); }
+
+  // --- Probe into user entry ---
+  bool probe_into(std::uint64_t key, TTEntry5& out) const noexcept {
+    const Cluster& c = table_[index(key)];
+    LILIA_PREFETCH_L1(&c);
+    const std::uint8_t cur = static_cast<std::uint8_t>(generation_.load(std::memory_order_relaxed));
+    const TTProbeResult r = Layout::probe(c, key, cur, out);
+#if TT5_STATS
+    bump(stat_shard().probe[static_cast<int>(r)]);
+#endif
+    const bool hit = r == TTProbeResult::Hit;
+#if TT5_RECORD
+    if (tt_recorder) tt_recorder->on_probe(key, hit);
+#endif
+    return hit;
+  }
+
+  std::optional<TTEntry5> probe(std::uint64_t key) const {
+    TTEntry5 tmp{};
+    if (probe_into(key, tmp)) return tmp;
+    return std::nullopt;
+  }
+
+  void store(std::uint64_t key, int32_t value, int16_t depth, Bound bound, const Move& best,
+             int16_t staticEval = std::numeric_limits<int16_t>::min()) noexcept {
+    Cluster& c = table_[index(key)];
+    LILIA_PREFETCHW_L1(&c);
+
+    const std::uint8_t age = static_cast<std::uint8_t>(generation_.load(std::memory_order_relaxed));
+    const std::uint8_t depth8 =
+        static_cast<std::uint8_t>(depth < 0 ? 0 : (depth > 255 ? 255 : depth));
+    const std::int16_t v16 = static_cast<std::int16_t>(std::clamp(
+        value, (int)std::numeric_limits<int16_t>::min(), (int)std::numeric_limits<int16_t>::max()));
+    const std::int16_t se16 = static_cast<std::int16_t>(std::clamp(
+        staticEval, std::numeric_limits<int16_t>::min(), std::numeric_limits<int16_t>::max()));
+    const std::uint16_t mv16 = tt_detail::pack_move16(best);
+#if TT5_RECORD
+    if (tt_recorder) tt_recorder->on_store(key, v16, depth8, bound, mv16, se16);
+#endif
+    const TTStoreResult r = Layout::store(c, key, age, depth8, bound, mv16, v16, se16);
+#if TT5_STATS
+    bump(stat_shard().store[static_cast<int>(r)]);
+#else
+    (void)r;
+#endif
+  }
+
+  // UCI "hashfull": permille of the entries in the first HASHFULL_SAMPLE clusters that
+  // were written (or refreshed) by the current search.
+  int hashfull() const noexcept {
+    const std::size_t n = std::min<std::size_t>(slots_, HASHFULL_SAMPLE);
+    const std::uint8_t cur = static_cast<std::uint8_t>(generation_.load(std::memory_order_relaxed));
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < n; ++i) used += Layout::count_current(table_[i], cur);
+    return static_cast<int>(used * 1000 / (n * Layout::kEntries));
+  }
+
+  // Sums the per-thread counters. Racy snapshot while a search runs; all zero with
+  // TT5_STATS=0.
+  TTStats stats() const noexcept {
+    TTStats s{};
+#if TT5_STATS
+    std::uint64_t probe[PROBE_KINDS] = {};
+    std::uint64_t store[STORE_KINDS] = {};
+    for (const auto& sh : stats_) {
+      for (int i = 0; i < PROBE_KINDS; ++i) probe[i] += sh.probe[i].load(std::memory_order_relaxed);
+      for (int i = 0; i < STORE_KINDS; ++i) store[i] += sh.store[i].load(std::memory_order_relaxed);
+    }
+    s.hits = probe[static_cast<int>(TTProbeResult::Hit)];
+    s.keyMismatches = probe[static_cast<int>(TTProbeResult::KeyMismatch)];
+    s.probes = s.hits + s.keyMismatches + probe[static_cast<int>(TTProbeResult::Miss)];
+    s.emptyWrites = store[static_cast<int>(TTStoreResult::Empty)];
+    s.sameKeyWrites = store[static_cast<int>(TTStoreResult::SameKey)];
+    s.replacedStale = store[static_cast<int>(TTStoreResult::ReplaceStale)];
+    s.replacedShallow = store[static_cast<int>(TTStoreResult::ReplaceShallow)];
+    s.rejected = store[static_cast<int>(TTStoreResult::Rejected)];
+    s.stores = s.emptyWrites + s.sameKeyWrites + s.replacedStale + s.replacedShallow + s.rejected;
+#endif
+    return s;
+  }
+
+  // Only call while no search is running.
+  void reset_stats() noexcept {
+#if TT5_STATS
+    for (auto& sh : stats_) {
+      for (auto& a : sh.probe) a.store(0, std::memory_order_relaxed);
+      for (auto& a : sh.store) a.store(0, std::memory_order_relaxed);
+    }
+#endif
+  }
+
+ private:
+  // Maps a 64-bit hash uniformly onto [0, slots_) via the high half of hash * slots_.
+  static inline std::uint64_t mul_hi64(std::uint64_t a, std::uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return __umulh(a, b);
+#else
+    const std::uint64_t aL = (std::uint32_t)a, aH = a >> 32;
+    const std::uint64_t bL = (std::uint32_t)b, bH = b >> 32;
+    const std::uint64_t ll = aL * bL, lh = aL * bH, hl = aH * bL, hh = aH * bH;
+    const std::uint64_t mid = (ll >> 32) + (std::uint32_t)lh + (std::uint32_t)hl;
+    return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
+#endif
   }
 
   inline std::size_t index(std::uint64_t key) const noexcept {
-    // slots_ is power-of-two
 #if TT5_INDEX_MIX
     uint64_t x = key + 0x9E3779B97F4A7C15ull;
     x ^= x >> 30;
@@ -526,31 +947,77 @@ class TT5 {
     x *= 0x94D049BB133111EBull;
     x ^= x >> 31;
     uint64_t h = x;
-    return static_cast<std::size_t>(h) & (slots_ - 1);
 #else
-    return static_cast<std::size_t>(key) & (slots_ - 1);
+    // Multiply-shift nimmt die oberen Bits; keyHigh16 (Bits 48..63) steckt aber schon
+    // im Eintrag. Rotieren, damit Index und gespeicherte Key-Bits disjunkt bleiben.
+    uint64_t h = (key << 16) | (key >> 48);
 #endif
+    return static_cast<std::size_t>(mul_hi64(h, static_cast<std::uint64_t>(slots_)));
   }
 
-  static inline std::size_t highest_pow2(std::size_t x) noexcept {
-    if (x == 0) return 1;
-#if defined(__GNUC__) || defined(__clang__)
-    // next lower power of two
-    int lz = __builtin_clzll(static_cast<unsigned long long>(x));
-    std::size_t p = 1ull << (63 - lz);
-    if (p > x) p >>= 1;
-    return p ? p : 1;
-#else
-    // portable fallback
-    std::size_t p = 1;
-    while ((p << 1) && ((p << 1) <= x)) p <<= 1;
-    return p;
-#endif
+  static TTFileHeader make_header() noexcept {
+    TTFileHeader h{};
+    std::memcpy(h.magic, TT_FILE_MAGIC, sizeof(h.magic));
+    h.version = TT_FILE_VERSION;
+    h.headerBytes = static_cast<std::uint32_t>(TT_FILE_HEADER_BYTES);
+    h.clusterBytes = static_cast<std::uint32_t>(sizeof(Cluster));
+    h.entries = static_cast<std::uint32_t>(Layout::kEntries);
+    h.indexMix = TT5_INDEX_MIX;
+    std::strncpy(h.layout, Layout::kName, sizeof(h.layout) - 1);
+    return h;
+  }
+
+  void init_clusters(const ParallelFor& pf) {
+    const std::size_t n = std::min<std::size_t>(INIT_SLICES, slots_);
+    auto slice = [this, n](std::size_t i) {
+      const std::size_t b = slots_ * i / n;
+      const std::size_t e = slots_ * (i + 1) / n;
+      for (std::size_t k = b; k < e; ++k) ::new (static_cast<void*>(table_ + k)) Cluster();
+    };
+    if (pf && n > 1) {
+      pf(n, slice);
+    } else {
+      for (std::size_t i = 0; i < n; ++i) slice(i);
+    }
+  }
+
+  static constexpr std::size_t INIT_SLICES = 64;
+  static constexpr std::size_t HASHFULL_SAMPLE = 1000;
+
+#if TT5_STATS
+  static constexpr int PROBE_KINDS = static_cast<int>(TTProbeResult::Count);
+  static constexpr int STORE_KINDS = static_cast<int>(TTStoreResult::Count);
+  static constexpr std::size_t STAT_SHARDS = 64;
+
+  // One cache line per thread, so counting never bounces lines between cores.
+  struct alignas(64) StatShard {
+    std::atomic<std::uint64_t> probe[PROBE_KINDS] = {};
+    std::atomic<std::uint64_t> store[STORE_KINDS] = {};
+  };
+  static_assert(sizeof(StatShard) == 64);
+
+  // Threads get shards round-robin. Load+store instead of an RMW: a shard is
+  // single-writer unless more than STAT_SHARDS threads run, and then a lost count
+  // is acceptable for telemetry.
+  static inline void bump(std::atomic<std::uint64_t>& a) noexcept {
+    a.store(a.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+  StatShard& stat_shard() const noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t id = next.fetch_add(1, std::memory_order_relaxed) % STAT_SHARDS;
+    return stats_[id];
   }
 
-  std::unique_ptr<Cluster[]> table_;
+  mutable std::array<StatShard, STAT_SHARDS> stats_{};
+#endif
+
+  TTMemory mem_;
+  Cluster* table_ = nullptr;  // lives in mem_, clusters constructed in place
   std::size_t slots_ = 1;
+  bool largePages_ = true;
   std::atomic<std::uint32_t> generation_{1u};
 };
 
+using TT5 = BasicTT5<TT5_LAYOUT>;
+
 }  // namespace lilia::model
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+
+namespace lilia::model {
+
+// -----------------------------------------------------------------------------
+// Raw backing store for the transposition table.
+// Tries (in this order) 1 GB / 2 MB hugetlb pages, then a 2 MB aligned anonymous
+// mapping advised with MADV_HUGEPAGE (THP), then plain pages. The memory is NOT
+// initialised here – the owner first-touches it (possibly in parallel slices).
+// -----------------------------------------------------------------------------
+enum class PageKind : unsigned char {
+  Default,      // normale Seiten (4 KB o.ä.)
+  Transparent,  // THP per madvise angefragt, der Kernel entscheidet
+  Huge2M,       // explizite 2 MB hugetlb / Windows Large Pages
+  Huge1G,       // explizite 1 GB hugetlb
+  FileMapped    // private (copy-on-write) Abbildung einer gespeicherten TT-Datei
+};
+
+class TTMemory {
+ public:
+  TTMemory() = default;
+  ~TTMemory() { release(); }
+  TTMemory(const TTMemory&) = delete;
+  TTMemory& operator=(const TTMemory&) = delete;
+
+  // Frees any previous block. Returns nullptr only if even the fallback fails.
+  void* allocate(std::size_t bytes, bool largePages);
+  // Maps bytes [offset, offset + bytes) of the file copy-on-write; writes never reach the
+  // file. Without mmap support the range is read into freshly allocated memory instead.
+  // On failure the previous block is kept and nullptr is returned.
+  void* map_file(const char* path, std::size_t offset, std::size_t bytes);
+  void release() noexcept;
+  void swap(TTMemory& other) noexcept;
+
+  void* data() const noexcept { return ptr_; }
+  std::size_t size() const noexcept { return bytes_; }
+  PageKind page_kind() const noexcept { return kind_; }
+  std::size_t page_size() const noexcept;
+  // e.g. "2 MB (hugetlb)" – for "info string" output
+  const char* page_description() const noexcept;
+
+ private:
+  void* ptr_ = nullptr;      // aligned start handed out
+  void* base_ = nullptr;     // what the OS gave us (for unmap/free)
+  std::size_t mapLen_ = 0;   // length passed to the OS
+  std::size_t bytes_ = 0;    // requested bytes
+  PageKind kind_ = PageKind::Default;
+  bool mapped_ = false;      // base_ came from mmap/VirtualAlloc
+  bool fileView_ = false;    // Windows: base_ is a MapViewOfFile view
+};
+
+}  // namespace lilia::model
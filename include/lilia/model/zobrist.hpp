@@ -1,5 +1,6 @@
 #pragma once
 #include <cstdint>
+#include <utility>
 
 #include "board.hpp"
 #include "core/bitboard.hpp"
@@ -133,4 +134,78 @@ struct Zobrist {
   }
 };
 
+// -----------------------------------------------------------------------------
+// Cuckoo-Tabellen für upcomingRepetition(): für jeden reversiblen Zug einer Figur (kein Bauer)
+// zwischen zwei Feldern, die sie auf leerem Brett verbindet, der Key-Unterschied
+// piece[from] ^ piece[to] ^ side. Das sind 3668 Züge in 8192 Plätzen, zwei Hashes je Key.
+// -----------------------------------------------------------------------------
+namespace detail {
+
+inline constexpr int CUCKOO_SIZE = 8192;
+constexpr int cuckoo_h1(std::uint64_t k) noexcept {
+  return static_cast<int>(k & (CUCKOO_SIZE - 1));
+}
+constexpr int cuckoo_h2(std::uint64_t k) noexcept {
+  return static_cast<int>((k >> 16) & (CUCKOO_SIZE - 1));
+}
+
+struct CuckooTables {
+  bb::Bitboard key[CUCKOO_SIZE];
+  std::uint8_t from[CUCKOO_SIZE];
+  std::uint8_t to[CUCKOO_SIZE];
+  int count;
+};
+
+consteval bb::Bitboard empty_board_attacks(core::PieceType pt, core::Square s) {
+  switch (pt) {
+    case core::PieceType::Knight:
+      return bb::knight_attacks_from(s);
+    case core::PieceType::Bishop:
+      return bb::bishop_attacks(s, 0);
+    case core::PieceType::Rook:
+      return bb::rook_attacks(s, 0);
+    case core::PieceType::Queen:
+      return bb::queen_attacks(s, 0);
+    case core::PieceType::King:
+      return bb::king_attacks_from(s);
+    default:
+      return 0;
+  }
+}
+
+consteval CuckooTables generate_cuckoo() {
+  const Tables z = generate();  // dieselben Keys wie Zobrist::tables
+  CuckooTables t{};
+  constexpr core::PieceType PTs[5] = {core::PieceType::Knight, core::PieceType::Bishop,
+                                      core::PieceType::Rook, core::PieceType::Queen,
+                                      core::PieceType::King};
+  for (int c = 0; c < 2; ++c)
+    for (core::PieceType pt : PTs)
+      for (int s1 = 0; s1 < 64; ++s1)
+        for (int s2 = s1 + 1; s2 < 64; ++s2) {
+          const auto sq1 = static_cast<core::Square>(s1);
+          if (!(empty_board_attacks(pt, sq1) & bb::sq_bb(static_cast<core::Square>(s2)))) continue;
+
+          const int p = static_cast<int>(pt);
+          bb::Bitboard key = z.piece[c][p][s1] ^ z.piece[c][p][s2] ^ z.side;
+          std::uint8_t from = static_cast<std::uint8_t>(s1), to = static_cast<std::uint8_t>(s2);
+          // Verdrängen, bis ein Platz frei ist (Schlüssel 0 = leer)
+          int i = cuckoo_h1(key);
+          for (;;) {
+            std::swap(t.key[i], key);
+            std::swap(t.from[i], from);
+            std::swap(t.to[i], to);
+            if (key == 0) break;
+            i = (i == cuckoo_h1(key)) ? cuckoo_h2(key) : cuckoo_h1(key);
+          }
+          ++t.count;
+        }
+  return t;
+}
+
+}  // namespace detail
+
+inline constexpr detail::CuckooTables CUCKOO = detail::generate_cuckoo();
+static_assert(CUCKOO.count == 3668, "unexpected number of reversible piece moves");
+
 }  // namespace lilia::model
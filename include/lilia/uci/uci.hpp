@@ -1,19 +1,35 @@
 #pragma once
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "lilia/engine/config.hpp"
 #include "lilia/model/chess_game.hpp"
 
 namespace lilia {
 
+namespace engine {
+class BotEngine;
+}  // namespace engine
+
 class UCI {
  public:
-  UCI() = default;
+  UCI();
+  ~UCI();
   int run();
+  // "bench [depth] [threads] [hash]" – auch von der Kommandozeile (lilia_engine bench ...)
+  int bench(const std::vector<std::string>& args);
+  // "perft <depth> [threads] [fen]" von der Kommandozeile; im Protokoll: "go perft <depth>"
+  int perft(const std::vector<std::string>& args);
 
  private:
   void showOptions();
   void setOption(const std::string& line);
+  // Lazily creates the engine; it (and its TT) then lives for the whole session.
+  engine::BotEngine& engineSession();
+  void reportHash();
+  // "position ..." – replays only the new moves when the command extends the last one
+  void setPosition(const std::string& line);
 
   struct Options {
     engine::EngineConfig cfg{};
@@ -26,6 +42,10 @@ class UCI {
   std::string m_version = "1.0";
 
   model::ChessGame m_game;
+  // What m_game currently holds: base ("startpos" / FEN) and the moves applied on top
+  std::string m_posBase;
+  std::vector<std::string> m_posMoves;
+  std::unique_ptr<engine::BotEngine> m_engine;
 };
 
 }  // namespace lilia
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+
+#include "lilia/log/log.hpp"
+
+namespace lilia {
+
+// UCI-Protokoll nach stdout über den asynchronen Kanal (log::Channel): Aufrufer reihen fertige
+// Zeilen nur ein, der Writer-Thread schreibt sie in Reihenfolge. uci_out() geht nie verloren
+// und wartet notfalls auf die GUI (UCI-Thread: bestmove, readyok, ...); uci_info() ist für
+// Zwischenstände der Such-Threads und wird bei Rückstau verworfen statt zu warten.
+// Diagnosen laufen getrennt davon über LILIA_LOG nach stderr.
+//
+// Sammelt eine Ausgabe per operator<< und reiht sie am Ende des Ausdrucks ein:
+//   uci_info() << "info depth " << d << "\n";
+class UciLine {
+ public:
+  explicit UciLine(bool droppable = false) : droppable_(droppable) {}
+  UciLine(const UciLine&) = delete;
+  UciLine& operator=(const UciLine&) = delete;
+  ~UciLine() {
+    if (droppable_)
+      log::Channel::instance().info(os_.str());
+    else
+      log::Channel::instance().protocol(os_.str());
+  }
+
+  template <class T>
+  UciLine& operator<<(const T& v) {
+    os_ << v;
+    return *this;
+  }
+
+ private:
+  std::ostringstream os_;
+  bool droppable_;
+};
+
+inline UciLine uci_out() {
+  return UciLine{};
+}
+inline UciLine uci_info() {
+  return UciLine{true};
+}
+
+// Blockiert, bis alles Eingereihte geschrieben ist (vor quit / Programmende).
+inline void uci_flush() {
+  log::Channel::instance().flush();
+}
+
+}  // namespace lilia
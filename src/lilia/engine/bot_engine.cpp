@@ -1,14 +1,9 @@
 #include "lilia/engine/bot_engine.hpp"
 
-#define LOG 1
-
 #include <chrono>
-#include <condition_variable>
-#include <iostream>
 #include <memory>
-#include <mutex>
-#include <thread>
 
+#include "lilia/log/log.hpp"
 #include "lilia/model/chess_game.hpp"
 #include "lilia/uci/uci_helper.hpp"  // für move_to_uci falls gewünscht beim Logging
 
@@ -30,25 +25,33 @@ static inline std::string format_top_moves(const std::vector<std::pair<model::Mo
 }
 SearchResult BotEngine::findBestMove(model::ChessGame& gameState, int maxDepth, int thinkMillis,
                                      std::atomic<bool>* externalCancel) {
+  TimeLimits limits;
+  limits.movetime = thinkMillis;
+  limits.moveOverhead = 0;
+  limits.infinite = thinkMillis <= 0;
+  return findBestMove(gameState, maxDepth, limits, externalCancel);
+}
+
+SearchResult BotEngine::findBestMove(model::ChessGame& gameState, int maxDepth,
+                                     const TimeLimits& limits,
+                                     std::atomic<bool>* externalCancel,
+                                     const SearchLimits& goLimits) {
   SearchResult res;
   auto pos = gameState.getPositionRefForBot();
 
-  auto stopFlag = std::make_shared<std::atomic<bool>>(false);
-
-  std::mutex m;
-  std::condition_variable cv;
-  bool timerStop = false;
-
-  std::thread timer([&]() {
-    if (thinkMillis <= 0) return;
-    std::unique_lock<std::mutex> lk(m);
-    bool pred = cv.wait_for(lk, std::chrono::milliseconds(thinkMillis), [&] {
-      return timerStop || (externalCancel && externalCancel->load());
-    });
-    if (!pred || (externalCancel && externalCancel->load())) {
-      stopFlag->store(true);
+  // Harte Grenze (maximum) und externer Abbruch werden in der Suche selbst geprüft.
+  // Hat startClock() die Uhr schon gestartet, läuft sie seit dem "go" (inkl. ponderhit).
+  {
+    std::lock_guard<std::mutex> lk(m_tmMutex);
+    if (!m_activeTm) {
+      m_tm.start(limits);
+      m_activeTm = &m_tm;
     }
-  });
+  }
+  TimeManager& tm = m_tm;
+  const long long thinkMillis = tm.managed() ? tm.maximum() : 0;
+
+  auto stopFlag = std::make_shared<std::atomic<bool>>(false);
 
   using steady_clock = std::chrono::steady_clock;
   auto t0 = steady_clock::now();
@@ -57,29 +60,27 @@ SearchResult BotEngine::findBestMove(model::ChessGame& gameState, int maxDepth,
   std::string engineErr;
 
   try {
-    auto mv = m_engine.find_best_move(pos, maxDepth, stopFlag);
+    auto mv = m_engine.find_best_move(pos, maxDepth, stopFlag, &tm, externalCancel, &goLimits);
     res.bestMove = mv;  // std::optional<Move>
   } catch (const std::exception& e) {
     engineThrew = true;
     engineErr = e.what();
-    std::cerr << "[BotEngine] engine threw exception: " << e.what() << "\n";
+    LILIA_LOG(Error, Search) << "engine threw exception: " << e.what();
     res.bestMove.reset();
   } catch (...) {
     engineThrew = true;
     engineErr = "unknown exception";
-    std::cerr << "[BotEngine] engine threw unknown exception\n";
+    LILIA_LOG(Error, Search) << "engine threw unknown exception";
     res.bestMove.reset();
   }
 
-  auto t1 = steady_clock::now();
-  long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
-
   {
-    std::lock_guard<std::mutex> lk(m);
-    timerStop = true;
+    std::lock_guard<std::mutex> lk(m_tmMutex);
+    m_activeTm = nullptr;
   }
-  cv.notify_one();
-  if (timer.joinable()) timer.join();
+
+  auto t1 = steady_clock::now();
+  long long elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
 
   // >>> WICHTIG: Nur dann Stats übernehmen, wenn die Suche NICHT geworfen hat
   if (!engineThrew) {
@@ -90,54 +91,88 @@ SearchResult BotEngine::findBestMove(model::ChessGame& gameState, int maxDepth,
     res.topMoves.clear();
   }
 
-#if LOG
-
-  // Logging – alles optional-sicher
-  std::string reason;
-  if (externalCancel && externalCancel->load()) {
-    reason = "external-cancel";
-  } else if (engineThrew) {
-    reason = std::string("exception: ") + engineErr;
-  } else if (stopFlag->load() && thinkMillis > 0 && elapsedMs >= thinkMillis) {
-    reason = "timeout";
-  } else {
-    reason = "normal";
-  }
-  std::cout << "\n[BotEngine] Search finished: reason=" << reason << "\n";
-  std::cout << "[BotEngine] depth=" << maxDepth << " time=" << elapsedMs
-            << "ms maxTime=" << thinkMillis << "ms threads=" << m_engine.getConfig().threads
-            << "\n";
-
-  std::cout << "[BotEngine] info nodes=" << res.stats.nodes
-            << " nps=" << static_cast<long long>(res.stats.nps) << " time=" << res.stats.elapsedMs
-            << " bestScore=" << res.stats.bestScore;
-  if (res.stats.bestMove.has_value()) {
-    std::cout << " bestMove=" << move_to_uci(res.stats.bestMove.value());
-  }
-  std::cout << "\n";
-
-  if (!res.stats.bestPV.empty()) {
-    std::cout << "[BotEngine] pv ";
-    bool first = true;
-    for (auto& mv : res.stats.bestPV) {
-      if (!first) std::cout << "->";
-      first = false;
-      std::cout << move_to_uci(mv);
+  // Zusammenfassung nur für "Log Level debug" – sonst wird nichts formatiert
+  if (log::enabled(log::Level::Debug, log::Category::Search)) {
+    std::string reason;
+    if (externalCancel && externalCancel->load()) {
+      reason = "external-cancel";
+    } else if (engineThrew) {
+      reason = std::string("exception: ") + engineErr;
+    } else if (stopFlag->load() && thinkMillis > 0 && elapsedMs >= thinkMillis) {
+      reason = "timeout";
+    } else {
+      reason = "normal";
+    }
+    LILIA_LOG(Debug, Search) << "search finished: reason=" << reason << " depth=" << maxDepth
+                             << " time=" << elapsedMs << "ms optTime=" << tm.optimum()
+                             << "ms maxTime=" << thinkMillis
+                             << "ms threads=" << m_engine.getConfig().threads;
+
+    std::string best = res.stats.bestMove ? move_to_uci(*res.stats.bestMove) : "none";
+    LILIA_LOG(Debug, Search) << "nodes=" << res.stats.nodes
+                             << " nps=" << static_cast<long long>(res.stats.nps)
+                             << " time=" << res.stats.elapsedMs
+                             << " bestScore=" << res.stats.bestScore << " bestMove=" << best;
+
+    if (!res.stats.bestPV.empty()) {
+      std::string pv;
+      for (auto& mv : res.stats.bestPV) {
+        if (!pv.empty()) pv += "->";
+        pv += move_to_uci(mv);
+      }
+      LILIA_LOG(Debug, Search) << "pv " << pv;
+    }
+    if (!res.topMoves.empty()) {
+      LILIA_LOG(Debug, Search) << "topMoves " << format_top_moves(res.topMoves);
     }
-    std::cout << "\n";
-  }
-
-  if (!res.topMoves.empty()) {
-    std::cout << "[BotEngine] topMoves " << format_top_moves(res.topMoves) << "\n";
   }
-#else
-#endif
 
   return res;
 }
 
+void BotEngine::startClock(const TimeLimits& limits) {
+  std::lock_guard<std::mutex> lk(m_tmMutex);
+  m_tm.start(limits);
+  m_activeTm = &m_tm;
+}
+
+bool BotEngine::ponderhit() {
+  std::lock_guard<std::mutex> lk(m_tmMutex);
+  if (!m_activeTm) return false;
+  m_activeTm->ponderhit();
+  return true;
+}
+
 const SearchStats& BotEngine::getLastSearchStats() const {
   return m_engine.getLastSearchStats();
 }
 
+void BotEngine::setInfoCallback(InfoCallback cb) {
+  m_engine.setInfoCallback(std::move(cb));
+}
+
+void BotEngine::setConfig(const EngineConfig& cfg) {
+  m_engine.setConfig(cfg);
+}
+
+void BotEngine::newGame() {
+  m_engine.newGame();
+}
+
+const EngineConfig& BotEngine::getConfig() const {
+  return m_engine.getConfig();
+}
+
+std::string BotEngine::ttPageDescription() const {
+  return m_engine.ttPageDescription();
+}
+
+bool BotEngine::saveHash(const std::string& path) const {
+  return m_engine.saveHash(path);
+}
+
+bool BotEngine::loadHash(const std::string& path) {
+  return m_engine.loadHash(path);
+}
+
 }  // namespace lilia::engine
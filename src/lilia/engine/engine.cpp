@@ -1,11 +1,16 @@
 #include "lilia/engine/engine.hpp"
 
 #include <algorithm>
+#include <future>
+#include <string>
 #include <thread>  // hardware_concurrency
+#include <vector>
 
 #include "lilia/engine/eval.hpp"  // <- Evaluator
 #include "lilia/engine/move_order.hpp"
 #include "lilia/engine/search.hpp"
+#include "lilia/engine/search_threads.hpp"
+#include "lilia/engine/time_manager.hpp"
 #include "lilia/engine/thread_pool.hpp"
 #include "lilia/model/core/magic.hpp"
 
@@ -18,22 +23,44 @@ struct Engine::Impl {
   // Gemeinsame Evaluator-Instanz, von allen Searches/Threads genutzt
   std::shared_ptr<const Evaluator> eval;
   std::unique_ptr<Search> search;
+  // Lazy-SMP-Helfer (threads - 1), leben so lange wie die Engine
+  std::unique_ptr<SearchThreads> helpers;
 
-  explicit Impl(const EngineConfig& c) : cfg(c), tt(c.ttSizeMb) {
-    unsigned hw = std::thread::hardware_concurrency();
-    int logical = (hw > 0 ? (int)hw : 1);
-
-    if (cfg.threads <= 0) {
-      cfg.threads = std::max(1, logical - 1);  // auto
-    } else {
-      cfg.threads = std::clamp(cfg.threads, 1, logical);
-    }
+  explicit Impl(const EngineConfig& c) : cfg(c), tt(1, c.ttLargePages) {
+    cfg.threads = resolve_threads(cfg.threads);
 
     // Initialize thread pool once using the configured thread count
     ThreadPool::instance(cfg.threads);
 
+    // Erst jetzt in voller Größe: die Worker nullen die Tabelle scheibchenweise
+    tt.resize(cfg.ttSizeMb, parallel_for());
+
     eval = std::make_shared<Evaluator>();
     search = std::make_unique<Search>(tt, eval, cfg);
+    helpers = std::make_unique<SearchThreads>(tt, eval, cfg);
+    helpers->resize(cfg.threads - 1);
+  }
+
+  static int resolve_threads(int requested) {
+    unsigned hw = std::thread::hardware_concurrency();
+    int logical = (hw > 0 ? (int)hw : 1);
+    if (requested <= 0) return std::max(1, logical - 1);  // auto
+    return std::clamp(requested, 1, logical);
+  }
+
+  // Verteilt TT-Init-Slices auf die Pool-Worker (nur außerhalb einer Suche aufrufen)
+  model::TT5::ParallelFor parallel_for() const {
+    const int workers = cfg.threads;
+    return [workers](std::size_t n, const std::function<void(std::size_t)>& fn) {
+      const std::size_t t = std::min<std::size_t>(std::max(1, workers), n);
+      std::vector<std::future<void>> jobs;
+      jobs.reserve(t);
+      for (std::size_t w = 0; w < t; ++w)
+        jobs.emplace_back(ThreadPool::instance().submit([&fn, w, t, n] {
+          for (std::size_t i = w; i < n; i += t) fn(i);
+        }));
+      for (auto& j : jobs) j.get();
+    };
   }
 };
 
@@ -42,38 +69,64 @@ Engine::Engine(const EngineConfig& cfg) : pimpl(new Impl(cfg)) {
 }
 
 Engine::~Engine() {
-  try {
-    pimpl->tt.clear();
-  } catch (...) {
-  }
-  try {
-    if (pimpl->eval) pimpl->eval->clearCaches();
-  } catch (...) {
-  }
-  try {
-    if (pimpl->search) pimpl->search->clearSearchState();
-  } catch (...) {
-  }
+  // Kein tt.clear() hier: das würde die ganze Tabelle nur zum Wegwerfen neu allokieren.
   delete pimpl;
 }
 
-std::optional<model::Move> Engine::find_best_move(model::Position& pos, int maxDepth,
-                                                  std::shared_ptr<std::atomic<bool>> stop) {
-  if (maxDepth <= 0) maxDepth = pimpl->cfg.maxDepth;
+void Engine::setConfig(const EngineConfig& cfg) {
+  const std::size_t oldTtMb = pimpl->cfg.ttSizeMb;
+  const bool oldLargePages = pimpl->cfg.ttLargePages;
 
-  // Suche immer sauber zurücksetzen (Killers/History etc.)
-  try {
-    pimpl->search->clearSearchState();
-  } catch (...) {
+  // Search hält eine Referenz auf pimpl->cfg -> in place aktualisieren
+  pimpl->cfg = cfg;
+  pimpl->cfg.threads = Impl::resolve_threads(cfg.threads);
+  ThreadPool::instance().maybe_resize(pimpl->cfg.threads);
+  pimpl->helpers->resize(pimpl->cfg.threads - 1);
+
+  if (pimpl->cfg.ttSizeMb != oldTtMb || pimpl->cfg.ttLargePages != oldLargePages) {
+    pimpl->tt.set_large_pages(pimpl->cfg.ttLargePages);
+    pimpl->tt.resize(pimpl->cfg.ttSizeMb, pimpl->parallel_for());
   }
+}
+
+void Engine::newGame() {
+  pimpl->tt.clear(pimpl->parallel_for());
+  if (pimpl->eval) pimpl->eval->clearCaches();
+  if (pimpl->search) pimpl->search->clearSearchState();
+  pimpl->helpers->clear();
+}
+
+std::optional<model::Move> Engine::find_best_move(model::Position& pos, int maxDepth,
+                                                  std::shared_ptr<std::atomic<bool>> stop,
+                                                  TimeManager* tm,
+                                                  const std::atomic<bool>* cancel,
+                                                  const SearchLimits* limits) {
+  if (maxDepth <= 0) {
+    maxDepth = pimpl->cfg.maxDepth;
+    // go mate N braucht mindestens 2N-1 Halbzüge
+    if (limits && limits->mate > 0) maxDepth = std::max(maxDepth, 2 * limits->mate);
+  }
+  const std::uint64_t maxNodes =
+      (limits && limits->nodes) ? limits->nodes : pimpl->cfg.maxNodes;
+
+  // Killers/History bleiben zwischen den Zügen einer Partie erhalten
+  // (decay_tables altert sie pro Iteration); Reset nur über newGame().
 
   // 1) Suche ausführen – niemals Exceptions nach außen lassen
+  SearchDeadline deadline;
+  deadline.tm = tm;
+  deadline.cancel = cancel;
+  pimpl->search->set_time_manager(tm);
+  pimpl->search->set_deadline(deadline);
+  pimpl->search->set_limits(limits ? *limits : SearchLimits{});
   try {
-    (void)pimpl->search->search_root_lazy_smp(pos, maxDepth, stop, pimpl->cfg.threads
-                                              /*,pimpl->cfg.maxNodes*/);
+    (void)pimpl->search->search_root_lazy_smp(pos, maxDepth, stop, *pimpl->helpers, maxNodes);
   } catch (...) {
     // Wir fallen gleich auf TT/Legal zurück; keine Weitergabe
   }
+  pimpl->search->set_time_manager(nullptr);
+  pimpl->search->set_deadline(SearchDeadline{});
+  pimpl->search->set_limits(SearchLimits{});
 
   // 2) BestMove aus Stats, wenn vorhanden
   const auto& stats = pimpl->search->getStats();
@@ -97,19 +150,15 @@ std::optional<model::Move> Engine::find_best_move(model::Position& pos, int maxD
   // 4) Letzter Fallback: generiere legale Züge und wähle eine vernünftige Heuristik
   try {
     model::MoveGenerator mg;
-    std::vector<model::Move> pseudo;
-    pseudo.reserve(128);
-    mg.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), pseudo);
+    std::vector<model::Move> legal;
+    mg.generateLegalMoves(pos.getBoard(), pos.getState(), legal);
 
-    // Legal filtern und „gute“ Züge bevorzugen (Captures/Promos via MVV-LVA)
+    // „Gute“ Züge bevorzugen (Captures/Promos via MVV-LVA)
     std::optional<model::Move> bestCapPromo;
     int bestCapScore = std::numeric_limits<int>::min();
     std::optional<model::Move> firstLegal;
 
-    for (auto& m : pseudo) {
-      model::Position tmp = pos;
-      if (!tmp.doMove(m)) continue;  // illegal -> raus
-
+    for (auto& m : legal) {
       if (m.isCapture() || m.promotion() != core::PieceType::None) {
         int sc = mvv_lva_fast(pos, m);  // vorhandene Heuristik
         if (!bestCapPromo || sc > bestCapScore) {
@@ -135,8 +184,30 @@ const SearchStats& Engine::getLastSearchStats() const {
   return pimpl->search->getStats();
 }
 
+void Engine::setInfoCallback(std::function<void(const SearchInfo&)> cb) {
+  pimpl->search->set_info_callback(std::move(cb));
+}
+
 const EngineConfig& Engine::getConfig() const {
   return pimpl->cfg;
 }
 
+bool Engine::saveHash(const std::string& path) const {
+  return pimpl->tt.save(path);
+}
+
+bool Engine::loadHash(const std::string& path) {
+  if (!pimpl->tt.load(path)) return false;
+  pimpl->cfg.ttSizeMb = pimpl->tt.size_bytes() / (1024ull * 1024ull);
+  return true;
+}
+
+std::size_t Engine::ttPageSize() const {
+  return pimpl->tt.page_size();
+}
+
+std::string Engine::ttPageDescription() const {
+  return pimpl->tt.page_description();
+}
+
 }  // namespace lilia::engine
@@ -1877,6 +1877,11 @@ static int fianchetto_structure_ksmg(const std::array<Bitboard, 6>& W,
   return score_side(true) - score_side(false);
 }
 
+void Evaluator::prefetch(std::uint64_t key, std::uint64_t pawnKey) const noexcept {
+  prefetch_ro(&m_impl->eval[idx_eval(key)]);
+  prefetch_ro(&m_impl->pawn[idx_pawn(pawnKey)]);
+}
+
 // =============================================================================
 // evaluate() – white POV
 // =============================================================================
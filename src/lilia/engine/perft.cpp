@@ -0,0 +1,144 @@
+#include "lilia/engine/perft.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "lilia/engine/move_buffer.hpp"
+#include "lilia/model/move_generator.hpp"
+#include "lilia/model/position.hpp"
+
+namespace lilia::engine {
+
+namespace {
+
+// Geteilte Perft-Hash: ein Eintrag je Slot, lockless über check = key ^ nodes. Ein zerrissener
+// Eintrag (zwei Threads schreiben gleichzeitig) fällt beim Probe durch die XOR-Probe.
+class PerftHash {
+ public:
+  explicit PerftHash(std::size_t mb) {
+    const std::size_t want = std::max<std::size_t>(1, (mb << 20) / sizeof(Entry));
+    const std::size_t n = std::bit_floor(want);
+    entries_.reset(new Entry[n]());
+    mask_ = n - 1;
+  }
+
+  bool probe(std::uint64_t key, int depth, std::uint64_t& nodes) const noexcept {
+    const std::uint64_t k = mix(key, depth);
+    const Entry& e = entries_[k & mask_];
+    const std::uint64_t n = e.nodes.load(std::memory_order_relaxed);
+    if ((e.check.load(std::memory_order_relaxed) ^ n) != k) return false;
+    nodes = n;
+    return true;
+  }
+
+  void store(std::uint64_t key, int depth, std::uint64_t nodes) noexcept {
+    const std::uint64_t k = mix(key, depth);
+    Entry& e = entries_[k & mask_];
+    e.check.store(k ^ nodes, std::memory_order_relaxed);
+    e.nodes.store(nodes, std::memory_order_relaxed);
+  }
+
+ private:
+  struct Entry {
+    std::atomic<std::uint64_t> check{0};
+    std::atomic<std::uint64_t> nodes{0};
+  };
+
+  // Tiefe in den Schlüssel mischen: gleiche Stellung auf anderer Resttiefe = anderer Slot
+  static std::uint64_t mix(std::uint64_t key, int depth) noexcept {
+    return key ^ (static_cast<std::uint64_t>(depth) * 0x9E3779B97F4A7C15ull);
+  }
+
+  std::unique_ptr<Entry[]> entries_;
+  std::size_t mask_ = 0;
+};
+
+std::uint64_t perft_node(model::Position& pos, int depth, PerftHash* hash,
+                         const std::atomic<bool>* stop) {
+  std::uint64_t nodes = 0;
+  if (depth >= 2 && hash && hash->probe(pos.hash(), depth, nodes)) return nodes;
+  // Abbruch: nur in inneren Knoten prüfen, Teilergebnisse landen nicht in der Hash
+  if (depth >= 3 && stop && stop->load(std::memory_order_relaxed)) return 0;
+
+  model::MoveGenerator gen;
+  model::Move moves[MAX_MOVES];
+  MoveBuffer buf(moves, MAX_MOVES);
+  const int n = gen.generateLegalMoves(pos.getBoard(), pos.getState(), buf);
+
+  // Bulk Counting: der Generator ist legal, der letzte Ply muss nicht ausgeführt werden
+  if (depth == 1) return static_cast<std::uint64_t>(n);
+
+  for (int i = 0; i < n; ++i) {
+    pos.doMoveLegal(moves[i]);
+    nodes += perft_node(pos, depth - 1, hash, stop);
+    pos.undoMove();
+  }
+  if (stop && stop->load(std::memory_order_relaxed)) return nodes;
+  if (hash) hash->store(pos.hash(), depth, nodes);
+  return nodes;
+}
+
+}  // namespace
+
+PerftResult run_perft(const model::Position& root, int depth, int threads, std::size_t hashMb,
+                      const std::atomic<bool>* stop) {
+  using clock = std::chrono::steady_clock;
+  PerftResult res;
+  if (depth <= 0) {
+    res.nodes = 1;
+    return res;
+  }
+
+  std::unique_ptr<PerftHash> hash;
+  if (hashMb > 0 && depth >= 3) hash = std::make_unique<PerftHash>(hashMb);
+
+  const auto t0 = clock::now();
+
+  // Legale Root-Züge bestimmen (Divide-Liste)
+  model::Position pos = root;
+  model::MoveGenerator gen;
+  model::Move moves[MAX_MOVES];
+  MoveBuffer buf(moves, MAX_MOVES);
+  const int n = gen.generateLegalMoves(pos.getBoard(), pos.getState(), buf);
+  for (int i = 0; i < n; ++i) res.divide.emplace_back(moves[i], 1);
+
+  if (depth >= 2 && !res.divide.empty()) {
+    // Root-Züge dynamisch verteilen: jeder Worker holt sich den nächsten freien Index.
+    // Eigene Threads statt ThreadPool::instance(), damit die Thread-Zahl der Perft den Pool der
+    // Suche nicht vergrößert; der aufrufende Thread rechnet mit.
+    const std::size_t tasks =
+        std::min<std::size_t>(static_cast<std::size_t>(std::max(1, threads)), res.divide.size());
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [&res, &root, &next, depth, h = hash.get(), stop] {
+      model::Position local = root;
+      for (std::size_t i;
+           (i = next.fetch_add(1, std::memory_order_relaxed)) < res.divide.size();) {
+        if (stop && stop->load(std::memory_order_relaxed)) break;
+        local.doMoveLegal(res.divide[i].first);
+        res.divide[i].second = perft_node(local, depth - 1, h, stop);
+        local.undoMove();
+      }
+    };
+    std::vector<std::thread> helpers;
+    helpers.reserve(tasks - 1);
+    for (std::size_t t = 1; t < tasks; ++t) helpers.emplace_back(worker);
+    worker();
+    for (auto& t : helpers) t.join();
+  }
+  res.stopped = stop && stop->load();
+
+  for (const auto& d : res.divide) res.nodes += d.second;
+  res.elapsedMs = (std::uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+                      clock::now() - t0)
+                      .count();
+  res.nps = res.elapsedMs ? res.nodes * 1000 / res.elapsedMs : res.nodes;
+  return res;
+}
+
+}  // namespace lilia::engine
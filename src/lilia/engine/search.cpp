@@ -11,15 +11,15 @@
 #include <iostream>
 #include <limits>
 #include <memory>
-#include <mutex>
 #include <unordered_set>
 #include <vector>
 
 #include "lilia/engine/config.hpp"
 #include "lilia/engine/move_buffer.hpp"
-#include "lilia/engine/move_list.hpp"
 #include "lilia/engine/move_order.hpp"
-#include "lilia/engine/thread_pool.hpp"
+#include "lilia/engine/move_picker.hpp"
+#include "lilia/engine/search_threads.hpp"
+#include "lilia/engine/time_manager.hpp"
 #include "lilia/model/core/bitboard.hpp"
 #include "lilia/model/core/magic.hpp"
 
@@ -66,6 +66,12 @@ static constexpr int RFP_MARGIN_BASE = 190;    // vorher 180
 // LMP-Limits pro Tiefe (nur Quiet-Züge)
 static constexpr int LMP_LIMIT[4] = {0, 5, 9, 14};  // D=1..3
 static constexpr int LOW_MVV_MARGIN = 360;
+// SEE-Pruning (cfg.useSEEPruning): Quiets dürfen bis QUIET*d² hängen, Schläge bis CAPTURE*d
+// verlieren (d <= SEE_PRUNE_DEPTH), in der QSearch bis QS_SEE_MARGIN
+static constexpr int SEE_PRUNE_DEPTH = 4;
+static constexpr int SEE_QUIET_MARGIN = 24;
+static constexpr int SEE_CAPTURE_MARGIN = 90;
+static constexpr int QS_SEE_MARGIN = 80;
 
 namespace {
 
@@ -170,11 +176,6 @@ static inline int gen_all(model::MoveGenerator& mg, model::Position& pos, model:
   engine::MoveBuffer buf(out, cap);
   return mg.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), buf);
 }
-static inline int gen_caps(model::MoveGenerator& mg, model::Position& pos, model::Move* out,
-                           int cap) {
-  engine::MoveBuffer buf(out, cap);
-  return mg.generateCapturesOnly(pos.getBoard(), pos.getState(), buf);
-}
 static inline int gen_evasions(model::MoveGenerator& mg, model::Position& pos, model::Move* out,
                                int cap) {
   engine::MoveBuffer buf(out, cap);
@@ -264,113 +265,6 @@ static inline void decay_tables(Search& S, int shift /* e.g. 6 => ~1.6% */) {
           }
 }
 
-// 0 = no signal; 1 = attacks high-value piece; 2 = gives check
-struct CheckTables {
-  model::bb::Bitboard KN_FROM[64];
-  model::bb::Bitboard K_FROM[64];
-  model::bb::Bitboard PAWN_CHK[2][64];  // [us][kSq]
-  model::bb::Bitboard LINE[64][64];
-  model::bb::Bitboard BETWEEN[64][64];
-  model::bb::Bitboard RAY[64][64];  // ray starting at a towards b
-  int DIR[64][64];                  // -1 if not aligned, else 0..7 for N,NE,E,SE,S,SW,W,NW
-} CT;
-
-static inline void init_check_tables() {
-  using namespace lilia::model::bb;
-  for (int s = 0; s < 64; ++s) {
-    CT.KN_FROM[s] = knight_attacks_from(static_cast<core::Square>(s));
-    CT.K_FROM[s] = king_attacks_from(static_cast<core::Square>(s));
-  }
-  for (int k = 0; k < 64; ++k) {
-    auto kB = sq_bb(static_cast<core::Square>(k));
-    CT.PAWN_CHK[(int)core::Color::White][k] = sw(kB) | se(kB);
-    CT.PAWN_CHK[(int)core::Color::Black][k] = nw(kB) | ne(kB);
-  }
-
-  auto on_line = [&](int a, int b) -> bool {
-    int ra = rank_of(static_cast<core::Square>(a));
-    int fa = file_of(static_cast<core::Square>(a));
-    int rb = rank_of(static_cast<core::Square>(b));
-    int fb = file_of(static_cast<core::Square>(b));
-    return (ra == rb) || (fa == fb) || (std::abs(ra - rb) == std::abs(fa - fb));
-  };
-
-  auto dir_from_to = [&](int a, int b) -> int {
-    int ra = rank_of(static_cast<core::Square>(a));
-    int fa = file_of(static_cast<core::Square>(a));
-    int rb = rank_of(static_cast<core::Square>(b));
-    int fb = file_of(static_cast<core::Square>(b));
-    int dr = (rb > ra) - (rb < ra);  // -1,0,1
-    int df = (fb > fa) - (fb < fa);
-    if (dr == 0 && df == 0) return -1;
-    if (dr == 0 && df == 1) return 2;    // E
-    if (dr == 0 && df == -1) return 6;   // W
-    if (dr == 1 && df == 0) return 0;    // N
-    if (dr == -1 && df == 0) return 4;   // S
-    if (dr == 1 && df == 1) return 1;    // NE
-    if (dr == 1 && df == -1) return 7;   // NW
-    if (dr == -1 && df == 1) return 3;   // SE
-    if (dr == -1 && df == -1) return 5;  // SW
-    return -1;
-  };
-
-  auto step = [](int dir, model::bb::Bitboard b) {
-    using namespace lilia::model::bb;
-    switch (dir) {
-      case 0:
-        return north(b);
-      case 1:
-        return ne(b);
-      case 2:
-        return east(b);
-      case 3:
-        return se(b);
-      case 4:
-        return south(b);
-      case 5:
-        return sw(b);
-      case 6:
-        return west(b);
-      case 7:
-        return nw(b);
-    }
-    return (model::bb::Bitboard)0;
-  };
-
-  for (int a = 0; a < 64; ++a)
-    for (int b = 0; b < 64; ++b) {
-      CT.DIR[a][b] = dir_from_to(a, b);
-      if (!on_line(a, b)) {
-        CT.LINE[a][b] = 0;
-        CT.BETWEEN[a][b] = 0;
-        CT.RAY[a][b] = 0;
-        continue;
-      }
-      auto A = lilia::model::bb::sq_bb(static_cast<core::Square>(a));
-      auto B = lilia::model::bb::sq_bb(static_cast<core::Square>(b));
-      int d = CT.DIR[a][b];
-      // RAY[a][b]: from a toward b, exclusive
-      model::bb::Bitboard ray = 0, r = step(d, A);
-      while (r) {
-        ray |= r;
-        if (r & B) break;
-        r = step(d, r);
-      }
-      CT.RAY[a][b] = ray;
-      // BETWEEN[a][b]: squares strictly between
-      CT.BETWEEN[a][b] = ray & ~B;
-      // LINE[a][b]: whole line through a,b (union of both rays + endpoints)
-      // Build opposite ray too:
-      int dOpp = (d + 4) & 7;
-      model::bb::Bitboard rayOpp = 0, r2 = step(dOpp, A);
-      while (r2) {
-        rayOpp |= r2;
-        r2 = step(dOpp, r2);
-      }
-      CT.LINE[a][b] = ray | rayOpp | A | B;
-    }
-}
-
 // --- NEW: pre-move "would give check" detector (EP & promotion aware) ---
 struct QuietSignals {
   int pawnSignal = 0;
@@ -389,9 +283,9 @@ static inline bool xray_check_after_one_capture(const model::Position& pos, cons
   if (!(moverAfter == PT::Bishop || moverAfter == PT::Rook || moverAfter == PT::Queen))
     return false;
 
-  if (!CT.LINE[kingSq][m.to()]) return false;
+  if (!bb::line((core::Square)kingSq, m.to())) return false;
 
-  const auto between = CT.BETWEEN[kingSq][m.to()];
+  const auto between = bb::between((core::Square)kingSq, m.to());
   auto blockers = occ & between;
   if (!blockers) return false;
 
@@ -405,7 +299,10 @@ static inline bool xray_check_after_one_capture(const model::Position& pos, cons
   lilia::model::bb::Bitboard atk = 0;
 
   // Pawns that could capture the blocker
-  atk |= (CT.PAWN_CHK[(int)us][blSq] & B.getPieces(us, PT::Pawn));
+  const auto blBB = bb::sq_bb((core::Square)blSq);
+  const auto pawnFrom =
+      us == core::Color::White ? (bb::sw(blBB) | bb::se(blBB)) : (bb::nw(blBB) | bb::ne(blBB));
+  atk |= (pawnFrom & B.getPieces(us, PT::Pawn));
 
   // Knights / King
   atk |= (bb::knight_attacks_from((core::Square)blSq) & B.getPieces(us, PT::Knight));
@@ -447,45 +344,8 @@ static inline QuietSignals compute_quiet_signals(const model::Position& pos, con
   if (auto mover = board.getPiece(m.from())) moverBefore = mover->type;
   PT moverAfter = (m.promotion() != PT::None) ? m.promotion() : moverBefore;
 
-  // Direct check detection using precomputed tables and magics
-  if (moverAfter == PT::Pawn) {
-    if (CT.PAWN_CHK[(int)us][kingSq] & toBB) info.givesCheck = true;
-  } else if (moverAfter == PT::Knight) {
-    if (CT.KN_FROM[m.to()] & enemyKingBB) info.givesCheck = true;
-  } else if (moverAfter == PT::King) {
-    if (CT.K_FROM[m.to()] & enemyKingBB) info.givesCheck = true;
-  } else if (moverAfter == PT::Bishop || moverAfter == PT::Rook || moverAfter == PT::Queen) {
-    if (CT.LINE[kingSq][m.to()] && (occ & CT.BETWEEN[kingSq][m.to()]) == 0) {
-      const bool rookLine = (CT.DIR[kingSq][m.to()] % 2 == 0);
-      const bool bishopLine = (CT.DIR[kingSq][m.to()] % 2 != 0);
-      if ((moverAfter == PT::Rook && rookLine) || (moverAfter == PT::Bishop && bishopLine) ||
-          moverAfter == PT::Queen)
-        info.givesCheck = true;
-    }
-  }
-
-  if (!info.givesCheck && CT.LINE[kingSq][m.from()]) {
-    const int dir = CT.DIR[kingSq][m.from()];
-    auto ray = CT.RAY[kingSq][m.from()];
-    auto blockers = occ & ray;
-    if (blockers) {
-      int firstSq;
-      // Use CTZ when indices grow along the ray: N(0), NE(1), E(2), NW(7)
-      if (dir == 0 || dir == 1 || dir == 2 || dir == 7)
-        firstSq = lilia::model::bb::ctz64(blockers);
-      else
-        firstSq = 63 - lilia::model::bb::clz64(blockers);
-
-      if (auto firstPiece = board.getPiece(firstSq); firstPiece && firstPiece->color == us) {
-        const bool rookLine = (dir % 2 == 0);
-        const bool bishopLine = (dir % 2 != 0);
-        if ((rookLine && (firstPiece->type == PT::Rook || firstPiece->type == PT::Queen)) ||
-            (bishopLine && (firstPiece->type == PT::Bishop || firstPiece->type == PT::Queen))) {
-          info.givesCheck = true;
-        }
-      }
-    }
-  }
+  // Direktes, Abzugs-, EP- und Rochadeschach aus der CheckInfo der Stellung
+  info.givesCheck = pos.givesCheck(m);
 
   // Quiet threat signals (only for non-capturing, non-promoting moves)
   if (!m.isCapture() && m.promotion() == PT::None) {
@@ -556,10 +416,54 @@ static inline QuietSignals compute_quiet_signals(const model::Position& pos, con
   return info;
 }
 
-inline void ensure_check_tables_initialized() {
-  static std::once_flag init_flag;
-  std::call_once(init_flag, [] { init_check_tables(); });
-}
+// Bewertung für den MovePicker: Schläge nach MVV-LVA, Quiets nach History + Threat-Signalen.
+// Quiet-Signale (compute_quiet_signals) laufen damit nur noch für Knoten, die die
+// Quiet-Stufe überhaupt erreichen.
+struct SearchOrdering {
+  const Search& S;
+  const model::Position& pos;
+  model::Move prev;  // Zug davor (Recapture / Countermove), from == to wenn keiner
+
+  int capture_score(const model::Move& m) const { return mvv_lva_fast(pos, m); }
+
+  // Recaptures, große Opfer (T/D) und Umwandlungen gelten auch bei SEE < 0 als "gut"
+  bool good_capture(const model::Move& m, int see) const {
+    if (m.promotion() != core::PieceType::None) return true;
+    if (prev.from() != prev.to() && prev.to() == m.to()) return true;
+    if (!m.isEnPassant()) {
+      if (auto cap = pos.getBoard().getPiece(m.to());
+          cap && (cap->type == core::PieceType::Rook || cap->type == core::PieceType::Queen))
+        return true;
+    }
+    return see >= 0;
+  }
+
+  int quiet_score(const model::Move& m) const {
+    auto moverOpt = pos.getBoard().getPiece(m.from());
+    const core::PieceType moverPt = moverOpt ? moverOpt->type : core::PieceType::Pawn;
+    int s = S.history[m.from()][m.to()] + (S.quietHist[pidx(moverPt)][m.to()] >> 1);
+    // kleiner Malus für schwere, nicht-taktische Umstellungen
+    if (moverPt == core::PieceType::Queen || moverPt == core::PieceType::Rook) s -= 6000;
+
+    const auto sig = compute_quiet_signals(pos, m);
+    if (sig.givesCheck)
+      s += 90'000;
+    else if (sig.pawnSignal > 0 || sig.pieceSignal > 0)
+      s += 40'000;
+    return s;
+  }
+
+  int evasion_score(const model::Move& m) const {
+    if (m.isCapture()) return 100'000 + mvv_lva_fast(pos, m);
+    int s = S.history[m.from()][m.to()];
+    if (m.promotion() != core::PieceType::None) s += 60'000;
+    if (prev.from() != prev.to() && m == S.counterMove[prev.from()][prev.to()])
+      s += 80'000;
+    return s;
+  }
+};
+
+using SearchMovePicker = MovePicker<SearchOrdering>;
 
 }  // namespace
 
@@ -584,7 +488,6 @@ Search::Search(model::TT5& tt_, std::shared_ptr<const Evaluator> eval_, const En
   sharedNodes.reset();  // NEW
   nodeLimit = 0;        // NEW
   stats = SearchStats{};
-  ensure_check_tables_initialized();
 }
 
 int Search::signed_eval(model::Position& pos) {
@@ -595,28 +498,53 @@ int Search::signed_eval(model::Position& pos) {
 
 namespace {
 
+// Knotenzählung je Thread. Ohne Limit wird im Nachhinein in Blöcken von TICK_STEP auf den
+// gemeinsamen Zähler gebucht. Mit Limit reserviert der Thread seine Knoten vorher (lease) und
+// gibt Ungenutztes beim Flush zurück: Der Zähler überschreitet das Limit nie und stimmt nach
+// dem Flush aller Threads exakt.
 class ThreadNodeBatch {
  public:
-  void reset() { local_ = 0; }
+  void reset() {
+    local_ = 0;
+    flushed_ = 0;
+    leased_ = 0;
+    limited_ = false;
+  }
+  // Knoten dieses Threads seit reset() (geflusht + lokal), für Root-Knotenanteile
+  std::uint64_t searched() const noexcept { return flushed_ + local_; }
 
   void bump(const std::shared_ptr<std::atomic<std::uint64_t>>& counter, std::uint64_t limit,
-            const std::shared_ptr<std::atomic<bool>>& stopFlag) {
+            const std::shared_ptr<std::atomic<bool>>& stopFlag, const SearchDeadline& deadline) {
+    if (limit && counter) {
+      if (leased_ == 0) lease(*counter, limit, stopFlag);
+      --leased_;
+    }
     ++local_;
     if ((local_ & 63u) == 0u) {
       if (stopFlag && stopFlag->load(std::memory_order_relaxed)) {
         throw SearchStoppedException();
       }
+      if ((local_ & (CLOCK_STEP - 1)) == 0u) check_deadline(deadline, stopFlag);
     }
     if (local_ >= TICK_STEP) {
-      flush_batch(counter, limit, stopFlag);
+      flush_batch(counter, stopFlag);
     }
   }
 
   std::uint64_t flush(const std::shared_ptr<std::atomic<std::uint64_t>>& counter) {
     if (!counter) {
+      flushed_ += local_;
       local_ = 0;
       return 0;
     }
+    if (limited_) {
+      // Knoten sind schon gebucht; nur den ungenutzten Rest der Reservierung zurückgeben
+      flushed_ += local_;
+      local_ = 0;
+      if (leased_) counter->fetch_sub(leased_, std::memory_order_relaxed);
+      leased_ = 0;
+      return counter->load(std::memory_order_relaxed);
+    }
 
     const uint32_t pending = local_;
     if (pending == 0u) {
@@ -624,27 +552,51 @@ class ThreadNodeBatch {
     }
 
     local_ = 0;
+    flushed_ += pending;
     return counter->fetch_add(pending, std::memory_order_relaxed) + pending;
   }
 
  private:
-  void flush_batch(const std::shared_ptr<std::atomic<std::uint64_t>>& counter, std::uint64_t limit,
+  // Abgelaufen/abgebrochen: Flag setzen, damit Root-Schleife und andere Threads es sehen
+  static void check_deadline(const SearchDeadline& d,
+                             const std::shared_ptr<std::atomic<bool>>& stopFlag) {
+    const bool cancelled = d.cancel && d.cancel->load(std::memory_order_relaxed);
+    if (!cancelled && !(d.tm && d.tm->past_deadline())) return;
+    if (stopFlag) stopFlag->store(true, std::memory_order_relaxed);
+    throw SearchStoppedException();
+  }
+
+  // Nächsten Block reservieren; was über das Limit hinausginge, sofort zurückgeben
+  void lease(std::atomic<std::uint64_t>& counter, std::uint64_t limit,
+             const std::shared_ptr<std::atomic<bool>>& stopFlag) {
+    limited_ = true;
+    const std::uint64_t before = counter.fetch_add(TICK_STEP, std::memory_order_relaxed);
+    const std::uint64_t granted =
+        before >= limit ? 0 : std::min<std::uint64_t>(TICK_STEP, limit - before);
+    if (granted < TICK_STEP) counter.fetch_sub(TICK_STEP - granted, std::memory_order_relaxed);
+    if (granted == 0) {
+      if (stopFlag) stopFlag->store(true, std::memory_order_relaxed);
+      throw SearchStoppedException();
+    }
+    leased_ = granted;
+  }
+
+  void flush_batch(const std::shared_ptr<std::atomic<std::uint64_t>>& counter,
                    const std::shared_ptr<std::atomic<bool>>& stopFlag) {
     local_ -= TICK_STEP;
-    if (counter) {
-      std::uint64_t cur = counter->fetch_add(TICK_STEP, std::memory_order_relaxed) + TICK_STEP;
-      if (limit && cur >= limit) {
-        if (stopFlag) stopFlag->store(true, std::memory_order_relaxed);
-        throw SearchStoppedException();
-      }
-    }
+    flushed_ += TICK_STEP;
+    if (counter && !limited_) counter->fetch_add(TICK_STEP, std::memory_order_relaxed);
     if (stopFlag && stopFlag->load(std::memory_order_relaxed)) {
       throw SearchStoppedException();
     }
   }
 
   static constexpr uint32_t TICK_STEP = 8192;
+  static constexpr uint32_t CLOCK_STEP = 1024;  // Deadline/Cancel: ein Clock-Read je 1024 Knoten
   uint32_t local_ = 0;
+  std::uint64_t flushed_ = 0;
+  std::uint64_t leased_ = 0;  // mit Limit: reserviert, noch nicht gesucht
+  bool limited_ = false;
 };
 
 ThreadNodeBatch& node_batch() {
@@ -679,18 +631,31 @@ class NodeFlushGuard {
 
 inline void bump_node_or_stop(const std::shared_ptr<std::atomic<std::uint64_t>>& counter,
                               std::uint64_t limit,
-                              const std::shared_ptr<std::atomic<bool>>& stopFlag) {
-  node_batch().bump(counter, limit, stopFlag);
+                              const std::shared_ptr<std::atomic<bool>>& stopFlag,
+                              const SearchDeadline& deadline) {
+  node_batch().bump(counter, limit, stopFlag, deadline);
 }
 
 // ---------- Quiescence + QTT ----------
-int Search::quiescence(model::Position& pos, int alpha, int beta, int ply) {
-  bump_node_or_stop(sharedNodes, nodeLimit, stopFlag);
+int Search::quiescence_after_move(model::Position& pos, int alpha, int beta, int ply, int qply) {
+  return pos.lastMoveGaveCheck() ? quiescence<true>(pos, alpha, beta, ply, qply)
+                                 : quiescence<false>(pos, alpha, beta, ply, qply);
+}
+
+template <bool InCheck>
+int Search::quiescence(model::Position& pos, int alpha, int beta, int ply, int qply) {
+  bump_node_or_stop(sharedNodes, nodeLimit, stopFlag, deadline_);
+  if (ply > selDepth_) selDepth_ = ply;
 
   if (ply >= MAX_PLY - 2) return signed_eval(pos);
 
   // Draw / 50-move / repetition in qsearch too
-  if (pos.checkInsufficientMaterial() || pos.checkMoveRule() || pos.checkRepetition()) return 0;
+  if (pos.checkInsufficientMaterial() || pos.checkMoveRule() || pos.checkRepetition(ply)) return 0;
+  // Wiederholung mit einem Zug erzwingbar: Remis ist Untergrenze
+  if (alpha < 0 && pos.upcomingRepetition(ply)) {
+    alpha = 0;
+    if (alpha >= beta) return alpha;
+  }
 
   const int kply = cap_ply(ply);
   const uint64_t parentKey = pos.hash();
@@ -698,10 +663,12 @@ int Search::quiescence(model::Position& pos, int alpha, int beta, int ply) {
 
   model::Move bestMoveQ{};
 
-  // QTT probe (depth == 0)
+  // QTT probe (depth == 0); der Zug dient in jedem Fall der Ordnung
+  model::Move ttMoveQ{};
   {
     model::TTEntry5 tte{};
     if (tt.probe_into(pos.hash(), tte)) {
+      ttMoveQ = tte.best;
       const int ttVal = decode_tt_score(tte.value, kply);
       if (tte.depth == 0) {
         if (tte.bound == model::Bound::Exact) return ttVal;
@@ -711,52 +678,27 @@ int Search::quiescence(model::Position& pos, int alpha, int beta, int ply) {
     }
   }
 
-  const bool inCheck = pos.inCheck();
-  if (inCheck) {
-    // Evasions only
-    int n = gen_evasions(mg, pos, genArr_[kply], engine::MAX_MOVES);
-    if (n <= 0) {
-      const int ms = mated_in(ply);
-      if (!(stopFlag && stopFlag->load()))
-        tt.store(parentKey, encode_tt_score(ms, kply), 0, model::Bound::Exact, model::Move{},
-                 std::numeric_limits<int16_t>::min());
-      return ms;
-    }
-
-    constexpr int MAXM = engine::MAX_MOVES;
-    int scores[MAXM];
-    model::Move ordered[MAXM];
-
-    const model::Move prev = (ply > 0 ? prevMove[cap_ply(ply - 1)] : model::Move{});
-    const bool prevOk = !prev.isNull() && prev.from() != prev.to();
-    const model::Move cm = prevOk ? counterMove[prev.from()][prev.to()] : model::Move{};
+  const model::Move prev = (ply > 0 ? prevMove[cap_ply(ply - 1)] : model::Move{});
+  const SearchOrdering ord{*this, pos, prev};
 
-    for (int i = 0; i < n; ++i) {
-      const auto& m = genArr_[kply][i];
-      int s = 0;
-      if (prevOk && m == cm) s += 80'000;
-      if (m.isCapture()) s += 100'000 + mvv_lva_fast(pos, m);
-      if (m.promotion() != core::PieceType::None) s += 60'000;
-      s += history[m.from()][m.to()];
-      scores[i] = s;
-      ordered[i] = m;
-    }
-    sort_by_score_desc(scores, ordered, n);
+  if constexpr (InCheck) {
+    // Evasions only
+    SearchMovePicker mp(pos, mg, ord, SearchMovePicker::Mode::Evasion, ttMoveQ);
 
     int best = -INF;
     bool anyLegal = false;
 
-    for (int i = 0; i < n; ++i) {
+    int i = 0;
+    for (model::Move m; mp.next(m); ++i) {
       if ((i & 63) == 0) check_stop(stopFlag);
-      const model::Move m = ordered[i];
 
+      prefetch_child(pos, m);
       MoveUndoGuard g(pos);
       if (!g.doMove(m)) continue;
       anyLegal = true;
 
       prevMove[cap_ply(ply)] = m;
-      tt.prefetch(pos.hash());
-      int score = -quiescence(pos, -beta, -alpha, ply + 1);
+      int score = -quiescence_after_move(pos, -beta, -alpha, ply + 1, qply + 1);
       score = std::clamp(score, -MATE + 1, MATE - 1);
 
       if (score >= beta) {
@@ -790,217 +732,213 @@ int Search::quiescence(model::Position& pos, int alpha, int beta, int ply) {
                std::numeric_limits<int16_t>::min());
     }
     return best;
-  }
-
-  // Not in check: stand pat
-  const int stand = signed_eval(pos);
-  if (stand >= beta) {
-    if (!(stopFlag && stopFlag->load())) {
-      constexpr int16_t SE_UNSET = std::numeric_limits<int16_t>::min();
-      tt.store(parentKey, encode_tt_score(beta, kply), 0, model::Bound::Lower, model::Move{},
-               inCheck ? SE_UNSET : (int16_t)stand);
+  } else {
+    // Not in check: stand pat
+    const int stand = signed_eval(pos);
+    if (stand >= beta) {
+      if (!(stopFlag && stopFlag->load())) {
+        tt.store(parentKey, encode_tt_score(beta, kply), 0, model::Bound::Lower, model::Move{},
+                 (int16_t)stand);
+      }
+      return beta;
     }
-    return beta;
-  }
-  if (alpha < stand) alpha = stand;
+    if (alpha < stand) alpha = stand;
 
-  // Generate captures (+ non-capture promotions)
-  int qn = gen_caps(mg, pos, capArr_[kply], engine::MAX_MOVES);
-  if (qn < engine::MAX_MOVES) {
-    engine::MoveBuffer buf(capArr_[kply] + qn, engine::MAX_MOVES - qn);
-    qn += mg.generateNonCapturePromotions(pos.getBoard(), pos.getState(), buf);
-  }
+    // Captures (+ non-capture promotions), lazily in MVV-LVA order
+    SearchMovePicker mp(pos, mg, ord, SearchMovePicker::Mode::QSearch, ttMoveQ);
 
-  // Order captures/promos
-  constexpr int MAXM = engine::MAX_MOVES;
-  int qs[MAXM];
-  model::Move qord[MAXM];
-  for (int i = 0; i < qn; ++i) {
-    const auto& m = capArr_[kply][i];
-    qs[i] = mvv_lva_fast(pos, m);
-    qord[i] = m;
-  }
-  sort_by_score_desc(qs, qord, qn);
-
-  constexpr int DELTA_MARGIN = 112;
-  int best = stand;
-
-  for (int i = 0; i < qn; ++i) {
-    const model::Move m = qord[i];
-    if ((i & 63) == 0) check_stop(stopFlag);
-
-    const bool isCap = m.isCapture();
-    const bool isPromo = (m.promotion() != core::PieceType::None);
-    const int mvv = (isCap || isPromo) ? mvv_lva_fast(pos, m) : 0;
-
-    // --- 3) stricter low-MVV negative-SEE prune ---
-    if (isCap && !isPromo && mvv < LOW_MVV_MARGIN) {
-      const model::Move pm = (ply > 0 ? prevMove[cap_ply(ply - 1)] : model::Move{});
-      const bool isRecap = (!pm.isNull() && pm.to() == m.to());
-      const int toFile = bb::file_of(m.to());
-      const bool onCenterFile = (toFile == 3 || toFile == 4);  // d or e
-
-      if (!isRecap && !onCenterFile) {
-        if (!pos.see(m)) {
-          // EXCEPTION: likely a clearance sac for an advanced passer
-          const auto us = pos.getState().sideToMove;
-          if (!advanced_pawn_adjacent_to(pos.getBoard(), us, m.to())) continue;
+    constexpr int DELTA_MARGIN = 112;
+    int best = stand;
+
+    int i = 0;
+    for (model::Move m; mp.next(m); ++i) {
+      if ((i & 63) == 0) check_stop(stopFlag);
+
+      const bool isCap = m.isCapture();
+      const bool isPromo = (m.promotion() != core::PieceType::None);
+      const int mvv = (isCap || isPromo) ? mvv_lva_fast(pos, m) : 0;
+      const int seeVal = (isCap && !isPromo) ? mp.last_see() : 0;
+
+      // --- 3) stricter low-MVV negative-SEE prune ---
+      if (isCap && !isPromo && mvv < LOW_MVV_MARGIN) {
+        const model::Move pm = (ply > 0 ? prevMove[cap_ply(ply - 1)] : model::Move{});
+        const bool isRecap = (!pm.isNull() && pm.to() == m.to());
+        const int toFile = bb::file_of(m.to());
+        const bool onCenterFile = (toFile == 3 || toFile == 4);  // d or e
+
+        if (!isRecap && !onCenterFile) {
+          if (seeVal < 0) {
+            // EXCEPTION: likely a clearance sac for an advanced passer
+            const auto us = pos.getState().sideToMove;
+            if (!advanced_pawn_adjacent_to(pos.getBoard(), us, m.to())) continue;
+          }
         }
       }
-    }
 
-    // SEE once if needed
-    bool seeOk = true;
-    if (isCap && !isPromo) {
-      const auto moverOptQ = pos.getBoard().getPiece(m.from());
-      const core::PieceType attackerPtQ = moverOptQ ? moverOptQ->type : core::PieceType::Pawn;
-      const int attackerValQ = base_value[(int)attackerPtQ];
-      int victimValQ = 0;
-      if (m.isEnPassant())
-        victimValQ = base_value[(int)core::PieceType::Pawn];
-      else if (auto capQ = pos.getBoard().getPiece(m.to()))
-        victimValQ = base_value[(int)capQ->type];
-
-      if (victimValQ < attackerValQ) {
-        seeOk = pos.see(m);
-        if (!seeOk && mvv < 400) continue;
+      // SEE once if needed
+      bool seeOk = true;
+      if (isCap && !isPromo) {
+        const auto moverOptQ = pos.getBoard().getPiece(m.from());
+        const core::PieceType attackerPtQ = moverOptQ ? moverOptQ->type : core::PieceType::Pawn;
+        const int attackerValQ = base_value[(int)attackerPtQ];
+        int victimValQ = 0;
+        if (m.isEnPassant())
+          victimValQ = base_value[(int)core::PieceType::Pawn];
+        else if (auto capQ = pos.getBoard().getPiece(m.to()))
+          victimValQ = base_value[(int)capQ->type];
+
+        if (victimValQ < attackerValQ) {
+          seeOk = seeVal >= 0;
+          if (!seeOk && mvv < 400) continue;
+        }
       }
-    }
 
-    const bool wouldGiveCheck = compute_quiet_signals(pos, m).givesCheck;
+      const bool wouldGiveCheck = pos.givesCheck(m);
 
-    // Delta pruning (skip if giving check) + discovered-check safeguard
-    if (!wouldGiveCheck) {
-      if (isCap || isPromo) {
-        int capVal = 0;
-        if (m.isEnPassant())
-          capVal = base_value[(int)core::PieceType::Pawn];
-        else if (isCap) {
-          if (auto cap = pos.getBoard().getPiece(m.to())) capVal = base_value[(int)cap->type];
-        }
-        int promoGain = 0;
-        if (isPromo)
-          promoGain =
-              std::max(0, base_value[(int)m.promotion()] - base_value[(int)core::PieceType::Pawn]);
-        const bool quietPromo = isPromo && !isCap;
-
-        bool shouldPrune = quietPromo ? (stand + promoGain + DELTA_MARGIN <= alpha)
-                                      : (stand + capVal + promoGain + DELTA_MARGIN <= alpha);
-
-        if (shouldPrune) {
-          // Quick discovered-check safety: if the move actually gives check, don't prune
-          MoveUndoGuard cg(pos);
-          if (cg.doMove(m) && pos.lastMoveGaveCheck()) {
-            cg.rollback();  // fall through to normal search
-          } else {
-            // illegal or no-check -> keep pruned
-            continue;
+      // klar verlierende Schläge (ohne Schach) gar nicht erst probieren
+      if (cfg.useSEEPruning && !wouldGiveCheck && seeVal < -QS_SEE_MARGIN) continue;
+
+      // Delta pruning (skip if giving check) + discovered-check safeguard
+      if (!wouldGiveCheck) {
+        if (isCap || isPromo) {
+          int capVal = 0;
+          if (m.isEnPassant())
+            capVal = base_value[(int)core::PieceType::Pawn];
+          else if (isCap) {
+            if (auto cap = pos.getBoard().getPiece(m.to())) capVal = base_value[(int)cap->type];
           }
+          int promoGain = 0;
+          if (isPromo)
+            promoGain = std::max(
+                0, base_value[(int)m.promotion()] - base_value[(int)core::PieceType::Pawn]);
+          const bool quietPromo = isPromo && !isCap;
+
+          bool shouldPrune = quietPromo ? (stand + promoGain + DELTA_MARGIN <= alpha)
+                                        : (stand + capVal + promoGain + DELTA_MARGIN <= alpha);
+
+          // givesCheck deckt auch Abzugsschach ab, kein make/unmake zur Absicherung nötig
+          if (shouldPrune) continue;
         }
       }
-    }
 
-    MoveUndoGuard g(pos);
-    if (!g.doMove(m)) continue;
+      prefetch_child(pos, m);
+      MoveUndoGuard g(pos);
+      if (!g.doMove(m)) continue;
 
-    prevMove[cap_ply(ply)] = m;
-    tt.prefetch(pos.hash());
-    int score = -quiescence(pos, -beta, -alpha, ply + 1);
-    score = std::clamp(score, -MATE + 1, MATE - 1);
+      prevMove[cap_ply(ply)] = m;
+      int score = -quiescence_after_move(pos, -beta, -alpha, ply + 1, qply + 1);
+      score = std::clamp(score, -MATE + 1, MATE - 1);
 
-    if (score >= beta) {
-      if (!(stopFlag && stopFlag->load()))
-        tt.store(parentKey, encode_tt_score(beta, kply), 0, model::Bound::Lower, m, (int16_t)stand);
-      return beta;
-    }
-    if (score > alpha) alpha = score;
-    if (score > best) {
-      best = score;
-      bestMoveQ = m;
+      if (score >= beta) {
+        if (!(stopFlag && stopFlag->load()))
+          tt.store(parentKey, encode_tt_score(beta, kply), 0, model::Bound::Lower, m,
+                   (int16_t)stand);
+        return beta;
+      }
+      if (score > alpha) alpha = score;
+      if (score > best) {
+        best = score;
+        bestMoveQ = m;
+      }
     }
-  }
 
-  // --- NEW: limited quiet checks in qsearch (not just low material) ---
-  if (best < beta) {
-    // MATERIAL gate: don't add quiet checks in bare endgames (king chases)
-    auto countSideNP = [&](core::Color c) {
-      using PT = core::PieceType;
-      const auto& B = pos.getBoard();
-      return model::bb::popcount(B.getPieces(c, PT::Knight) | B.getPieces(c, PT::Bishop) |
-                                 B.getPieces(c, PT::Rook) | B.getPieces(c, PT::Queen));
-    };
-    const int nonP = countSideNP(core::Color::White) + countSideNP(core::Color::Black);
-    if (nonP >= 2) {          // skip in K+minor vs K or K vs K situations
-      const int LIMIT = 10;   // keep small
-      const int MARGIN = 64;  // only try if position isn't already hopeless for side-to-move
-
-      if (stand + MARGIN > alpha) {
-        int an = gen_all(mg, pos, genArr_[kply], engine::MAX_MOVES);
-
-        struct QS {
-          model::Move m;
-          int s;
-        };
-        QS cand[engine::MAX_MOVES];
-        int cn = 0;
-
-        for (int i = 0; i < an; ++i) {
-          const model::Move m = genArr_[kply][i];
-          if (m.isCapture() || m.promotion() != core::PieceType::None) continue;
-          if (!compute_quiet_signals(pos, m).givesCheck) continue;
-
-          int sc = history[m.from()][m.to()];
-          if (m == killers[kply][0] || m == killers[kply][1]) sc += 6000;
-          cand[cn++] = {m, sc};
-        }
+    // --- NEW: limited quiet checks in qsearch (not just low material) ---
+    // Only at the first qsearch ply: check -> evasion -> check chains would otherwise
+    // recurse to MAX_PLY.
+    if (cfg.qsearchQuietChecks && qply == 0 && best < beta) {
+      // MATERIAL gate: don't add quiet checks in bare endgames (king chases)
+      auto countSideNP = [&](core::Color c) {
+        using PT = core::PieceType;
+        const auto& B = pos.getBoard();
+        return model::bb::popcount(B.getPieces(c, PT::Knight) | B.getPieces(c, PT::Bishop) |
+                                   B.getPieces(c, PT::Rook) | B.getPieces(c, PT::Queen));
+      };
+      const int nonP = countSideNP(core::Color::White) + countSideNP(core::Color::Black);
+      if (nonP >= 2) {          // skip in K+minor vs K or K vs K situations
+        const int LIMIT = 10;   // keep small
+        const int MARGIN = 64;  // only try if position isn't already hopeless for side-to-move
 
-        if (cn > 1) std::sort(cand, cand + cn, [](const QS& a, const QS& b) { return a.s > b.s; });
+        if (stand + MARGIN > alpha) {
+          int an = gen_all(mg, pos, genArr_[kply], engine::MAX_MOVES);
 
-        int tried = 0;
-        for (int i = 0; i < cn && tried < LIMIT; ++i) {
-          const model::Move m = cand[i].m;
+          struct QS {
+            model::Move m;
+            int s;
+          };
+          QS cand[engine::MAX_MOVES];
+          int cn = 0;
 
-          MoveUndoGuard g(pos);
-          if (!g.doMove(m)) continue;
+          for (int i = 0; i < an; ++i) {
+            const model::Move m = genArr_[kply][i];
+            if (m.isCapture() || m.promotion() != core::PieceType::None) continue;
+            if (!pos.givesCheck(m)) continue;
 
-          prevMove[cap_ply(ply)] = m;
-          int score = -quiescence(pos, -beta, -alpha, ply + 1);
-          score = std::clamp(score, -MATE + 1, MATE - 1);
-          ++tried;
+            int sc = history[m.from()][m.to()];
+            if (m == killers[kply][0] || m == killers[kply][1]) sc += 6000;
+            cand[cn++] = {m, sc};
+          }
 
-          if (score >= beta) {
-            if (!(stopFlag && stopFlag->load()))
-              tt.store(parentKey, encode_tt_score(beta, kply), 0, model::Bound::Lower, m,
-                       (int16_t)stand);
-            return beta;
+          if (cn > 1)
+            std::sort(cand, cand + cn, [](const QS& a, const QS& b) { return a.s > b.s; });
+
+          int tried = 0;
+          for (int i = 0; i < cn && tried < LIMIT; ++i) {
+            const model::Move m = cand[i].m;
+
+            MoveUndoGuard g(pos);
+            if (!g.doMove(m)) continue;
+
+            prevMove[cap_ply(ply)] = m;
+            int score = -quiescence_after_move(pos, -beta, -alpha, ply + 1, qply + 1);
+            score = std::clamp(score, -MATE + 1, MATE - 1);
+            ++tried;
+
+            if (score >= beta) {
+              if (!(stopFlag && stopFlag->load()))
+                tt.store(parentKey, encode_tt_score(beta, kply), 0, model::Bound::Lower, m,
+                         (int16_t)stand);
+              return beta;
+            }
+            if (score > best) best = score;
+            if (score > alpha) alpha = score;
           }
-          if (score > best) best = score;
-          if (score > alpha) alpha = score;
         }
       }
     }
-  }
 
-  if (!(stopFlag && stopFlag->load())) {
-    model::Bound b = model::Bound::Exact;
-    if (best <= alphaOrig)
-      b = model::Bound::Upper;
-    else if (best >= betaOrig)
-      b = model::Bound::Lower;
-    tt.store(parentKey, encode_tt_score(best, kply), 0, b, bestMoveQ, (int16_t)stand);
+    if (!(stopFlag && stopFlag->load())) {
+      model::Bound b = model::Bound::Exact;
+      if (best <= alphaOrig)
+        b = model::Bound::Upper;
+      else if (best >= betaOrig)
+        b = model::Bound::Lower;
+      tt.store(parentKey, encode_tt_score(best, kply), 0, b, bestMoveQ, (int16_t)stand);
+    }
+    return best;
   }
-  return best;
 }
 
 // ---------- Negamax ----------
 
+template <NodeType NT>
 int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int ply,
                     model::Move& refBest, int parentStaticEval, const model::Move* excludedMove) {
-  bump_node_or_stop(sharedNodes, nodeLimit, stopFlag);
+  using enum NodeType;
+  constexpr bool isPV = (NT == PV);
+  // Nullfenster-Kinder sind immer NonPV; Singular-Verifikation nur dort
+  if constexpr (isPV) excludedMove = nullptr;
+
+  bump_node_or_stop(sharedNodes, nodeLimit, stopFlag, deadline_);
+  if (ply > selDepth_) selDepth_ = ply;
 
   if (ply >= MAX_PLY - 2) return signed_eval(pos);
-  if (pos.checkInsufficientMaterial() || pos.checkMoveRule() || pos.checkRepetition()) return 0;
-  if (depth <= 0) return quiescence(pos, alpha, beta, ply);
+  if (pos.checkInsufficientMaterial() || pos.checkMoveRule() || pos.checkRepetition(ply)) return 0;
+  // Die Seite am Zug kann eine Wiederholung erzwingen: Remis einen Halbzug früher als Untergrenze
+  if (alpha < 0 && pos.upcomingRepetition(ply)) {
+    alpha = 0;
+    if (alpha >= beta) return alpha;
+  }
+  if (depth <= 0) return quiescence_after_move(pos, alpha, beta, ply);
 
   // Mate distance pruning
   alpha = std::max(alpha, mated_in(ply));
@@ -1009,7 +947,6 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
 
   const int origAlpha = alpha;
   const int origBeta = beta;
-  const bool isPV = (beta - alpha > 1);
 
   const bool inCheck = pos.inCheck();
 
@@ -1076,12 +1013,12 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
 
     if (depth == 1) {
       if (staticEval + RAZOR_D1 <= alpha) {
-        int q = quiescence(pos, alpha - 1, alpha, ply);
+        int q = quiescence<false>(pos, alpha - 1, alpha, ply);
         if (q <= alpha) return q;
       }
     } else {  // depth == 2
       if (staticEval + RAZOR_D2 <= alpha) {
-        int q = quiescence(pos, alpha - 1, alpha, ply);
+        int q = quiescence<false>(pos, alpha - 1, alpha, ply);
         if (q <= alpha) return q;
       }
     }
@@ -1100,10 +1037,8 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
     if (staticEval - margin >= beta) {
       // Cheap cutoff – this saves a lot of leaf work with basically no tactical risk.
       if (!(stopFlag && stopFlag->load())) {
-        constexpr int16_t SE_UNSET = std::numeric_limits<int16_t>::min();
         tt.store(pos.hash(), encode_tt_score(staticEval, cap_ply(ply)),
-                 /*depth*/ 0, model::Bound::Lower, /*best*/ model::Move{},
-                 inCheck ? SE_UNSET : (int16_t)staticEval);
+                 /*depth*/ 0, model::Bound::Lower, /*best*/ model::Move{}, (int16_t)staticEval);
       }
       return staticEval;
     }
@@ -1121,7 +1056,7 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
     int iidAlpha = isPV ? alpha : std::max(alpha, staticEval - 32);
     int iidBeta = isPV ? beta : (iidAlpha + 1);
 
-    (void)negamax(pos, iidDepth, iidAlpha, iidBeta, ply, iidBest, staticEval);
+    (void)negamax<NT>(pos, iidDepth, iidAlpha, iidBeta, ply, iidBest, staticEval);
     // re-probe TT to harvest best for ordering
     if (model::TTEntry5 tte2{}; tt.probe_into(pos.hash(), tte2)) {
       ttMove = tte2.best;
@@ -1174,14 +1109,15 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
       NullUndoGuard ng(pos);
       if (ng.doNull()) {
         model::Move tmpNM{};
-        int nullScore = -negamax(pos, depth - 1 - R, -beta, -beta + 1, ply + 1, tmpNM, -staticEval);
+        int nullScore =
+            -negamax<NonPV>(pos, depth - 1 - R, -beta, -beta + 1, ply + 1, tmpNM, -staticEval);
         ng.rollback();
         if (nullScore >= beta) {
           const bool needVerify = (depth >= 8 && R >= 3 && evalGap < 800);
           if (needVerify) {
             model::Move tmpVerify{};
             int verify =
-                -negamax(pos, depth - 1, -beta, -beta + 1, ply + 1, tmpVerify, -staticEval);
+                -negamax<NonPV>(pos, depth - 1, -beta, -beta + 1, ply + 1, tmpVerify, -staticEval);
             if (verify >= beta) return beta;
           } else {
             return beta;
@@ -1191,151 +1127,31 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
     }
   }
 
-  // Move generation
   const int kply = cap_ply(ply);
-  int n = 0;
-  if (inCheck) {
-    n = gen_evasions(mg, pos, genArr_[kply], engine::MAX_MOVES);
-    if (n <= 0) return mated_in(ply);
-  } else {
-    n = gen_all(mg, pos, genArr_[kply], engine::MAX_MOVES);
-    if (n <= 0) return 0;
-  }
 
   // prev for CounterMove
   const model::Move prev = (ply > 0 ? prevMove[cap_ply(ply - 1)] : model::Move{});
   const bool prevOk = !prev.isNull() && prev.from() != prev.to();
   const model::Move cm = prevOk ? counterMove[prev.from()][prev.to()] : model::Move{};
 
-  // --------- Staged move ordering (Stockfish-style) ---------
-  constexpr int MAX_MOVES = engine::MAX_MOVES;
-  int scores[MAX_MOVES];
-  model::Move ordered[MAX_MOVES];
-
-  // Large bucket to enforce stages (descending sort => higher bucket first)
-  constexpr int BUCKET = 10'000'000;
-
-  // stage weights (higher = earlier)
-  enum : int {
-    ST_TT = 5,
-    ST_GOOD_CAP = 4,
-    ST_KILLER_CM_QP = 3,  // killers, countermove, quiet promotions
-    ST_QUIET = 2,
-    ST_BAD_CAP = 1
-  };
-
-  constexpr int TT_BONUS = 2'400'000;
-  constexpr int CAP_BASE_GOOD = 180'000;
-  constexpr int CAP_BASE_BAD = 20'000;  // tiny base for losing caps (still searched)
-  constexpr int PROMO_BASE = 160'000;
-  constexpr int KILLER_BASE = 120'000;
-  constexpr int CM_BASE = 140'000;
+  // --------- Staged, lazy move ordering ---------
+  // TT → good captures → killers/countermove → quiets → bad captures; each stage is only
+  // generated/scored once the previous ones are exhausted.
+  const SearchOrdering ord{*this, pos, prev};
+  const model::Move refutations[3] = {killers[kply][0], killers[kply][1], cm};
+  SearchMovePicker mp(pos, mg, ord,
+                      inCheck ? SearchMovePicker::Mode::Evasion : SearchMovePicker::Mode::Main,
+                      haveTT ? ttMove : model::Move{}, refutations);
 
   const auto& board = pos.getBoard();
-
-  for (int i = 0; i < n; ++i) {
-    const auto& m = genArr_[kply][i];
-
-    // Skip duplicates of TT later by just giving TT the best bucket;
-    // search loop will naturally attempt TT first anyway.
-    int stage = ST_QUIET;  // default
-    int base = 0;
-
-    const bool isCap = m.isCapture();
-    const bool isPromo = (m.promotion() != core::PieceType::None);
-    const bool isQuiet = !isCap && !isPromo;
-
-    // recapture detection (useful to treat as "good cap")
-    const model::Move pm = (ply > 0 ? prevMove[cap_ply(ply - 1)] : model::Move{});
-    const bool isRecap = (!pm.isNull() && pm.to() == m.to());
-
-    // classify captures now: good vs bad (seeGood computed later per-move too,
-    // but we also need a quick pre-pass; we can recompute here cheaply)
-    bool seeGoodLocal = true;
-    core::PieceType capPt = core::PieceType::Pawn;
-    if (m.isEnPassant()) {
-      capPt = core::PieceType::Pawn;
-    } else if (isCap) {
-      if (auto cap = board.getPiece(m.to())) capPt = cap->type;
-    }
-    if (isCap && m.promotion() == core::PieceType::None) {
-      seeGoodLocal = pos.see(m);
-    }
-
-    // TT move first
-    if (haveTT && m == ttMove) {
-      stage = ST_TT;
-      base = TT_BONUS;
-    }
-    // Captures next (good first)
-    else if (isCap) {
-      const int mvv = mvv_lva_fast(pos, m);
-      // treat recaptures or big victims as "good", even if SEE<0
-      const bool bigVictim = (capPt == core::PieceType::Rook || capPt == core::PieceType::Queen);
-      const bool good = seeGoodLocal || isRecap || bigVictim || isPromo;
-
-      if (good) {
-        stage = ST_GOOD_CAP;
-        // lightweight capture history used here is optional; keep MVV as core
-        base = CAP_BASE_GOOD + mvv;
-      } else {
-        stage = ST_BAD_CAP;
-        base = CAP_BASE_BAD + mvv;  // still sorted among themselves
-      }
-    }
-    // Quiet promotions are high-priority quiets (like Stockfish)
-    else if (isPromo) {
-      stage = ST_KILLER_CM_QP;
-      base = PROMO_BASE;
-    }
-    // Killers & countermove
-    else if (m == killers[kply][0] || m == killers[kply][1]) {
-      stage = ST_KILLER_CM_QP;
-      base = KILLER_BASE;
-    } else {
-      const model::Move cm = (prevOk ? counterMove[prev.from()][prev.to()] : model::Move{});
-      if (prevOk && m == cm) {
-        stage = ST_KILLER_CM_QP;
-        base = CM_BASE + (counterHist[prev.from()][prev.to()] >> 1);
-      } else {
-        // regular quiet: history + quietHist + a tiny malus for heavy non-tactical shuffles
-        auto moverOpt = board.getPiece(m.from());
-        const core::PieceType moverPt = moverOpt ? moverOpt->type : core::PieceType::Pawn;
-        base = history[m.from()][m.to()] + (quietHist[pidx(moverPt)][m.to()] >> 1);
-
-        if (moverPt == core::PieceType::Queen || moverPt == core::PieceType::Rook) {
-          base -= 6000;  // small malus; your Search will still favor tactical quiets
-        }
-        stage = ST_QUIET;
-      }
-    }
-
-    {
-      const auto sig = compute_quiet_signals(pos, m);
-      if (sig.givesCheck) {
-        if (stage < ST_KILLER_CM_QP) stage = ST_KILLER_CM_QP;
-        base += 90'000;
-      } else if (sig.pawnSignal > 0 || sig.pieceSignal > 0) {
-        if (stage < ST_KILLER_CM_QP) stage = ST_KILLER_CM_QP;
-        base += 40'000;
-      }
-    }
-
-    scores[i] = stage * BUCKET + base;
-    ordered[i] = m;
-  }
-
-  // Staged order enforced by bucket; within each stage, your existing heuristics sort
-  sort_by_score_desc(scores, ordered, n);
-
   const bool allowFutility = !inCheck && !isPV;
   int moveCount = 0;
   bool searchedAny = false;
 
-  for (int idx = 0; idx < n; ++idx) {
+  int idx = 0;
+  for (model::Move m; mp.next(m); ++idx) {
     if ((idx & 63) == 0) check_stop(stopFlag);
 
-    const model::Move m = ordered[idx];
     if (excludedMove && m == *excludedMove) {
       continue;  // don’t skew LMR/LMP with a non-searched move
     }
@@ -1465,15 +1281,24 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
         continue;
       }
     }
-    // SEE once if needed (do not prune losing captures; just mark them "bad")
-    bool seeGood = true;
-    if (m.isCapture() && m.promotion() == core::PieceType::None) {
-      auto moverOptQ = board.getPiece(m.from());
-      const core::PieceType attackerPtQ = moverOptQ ? moverOptQ->type : core::PieceType::Pawn;
-
-      (void)attackerPtQ;  // attacker value no longer used for pruning here
-      // classify capture quality once for later (probcut / reductions / staging)
-      seeGood = pos.see(m);
+    // SEE: Schläge kommen mit exaktem Wert aus dem MovePicker (ProbCut / Reduktionen / Pruning)
+    const bool plainCapture = m.isCapture() && m.promotion() == core::PieceType::None;
+    const int seeVal = plainCapture ? mp.last_see() : 0;
+    const bool seeGood = seeVal >= 0;
+
+    // SEE-Pruning flacher Non-PV-Knoten: Quiets, die zu viel hängen lassen, und klar verlierende
+    // Schläge --- keine Schachs, keine taktischen Quiets
+    if (cfg.useSEEPruning && !isPV && !inCheck && !tacticalNode && depth <= SEE_PRUNE_DEPTH &&
+        moveCount > 0) {
+      if (isQuiet && !tacticalQuiet && !wouldCheck &&
+          !pos.see_ge(m, -SEE_QUIET_MARGIN * depth * depth)) {
+        ++moveCount;
+        continue;
+      }
+      if (plainCapture && seeVal < -SEE_CAPTURE_MARGIN * depth && !pos.givesCheck(m)) {
+        ++moveCount;
+        continue;
+      }
     }
 
     const int mvvBefore =
@@ -1494,7 +1319,7 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
         if (singBeta > -MATE + 64) {
           model::Move dummy{};
           const int sDepth = std::max(1, depth - 1 - R);
-          int s = negamax(pos, sDepth, singBeta - 1, singBeta, ply, dummy, staticEval, &m);
+          int s = negamax<NonPV>(pos, sDepth, singBeta - 1, singBeta, ply, dummy, staticEval, &m);
           if (s < singBeta) seExt = 1;
         }
       }
@@ -1532,6 +1357,7 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
       }
     }
 
+    prefetch_child(pos, m);
     MoveUndoGuard g(pos);
     if (!g.doMove(m)) {
       ++moveCount;
@@ -1539,7 +1365,6 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
     }
 
     prevMove[cap_ply(ply)] = m;
-    tt.prefetch(pos.hash());
 
     int value;
     model::Move childBest{};
@@ -1551,7 +1376,7 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
         const int red = 3;
         const int pcDepth = std::max(1, newDepth - red);
         const int probe =
-            -negamax(pos, pcDepth, -beta, -(beta - 1), ply + 1, childBest, -staticEval);
+            -negamax<NonPV>(pos, pcDepth, -beta, -(beta - 1), ply + 1, childBest, -staticEval);
         if (probe >= beta) return beta;
       }
     }
@@ -1568,7 +1393,7 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
         const model::Move pm = (ply > 0 ? prevMove[cap_ply(ply - 1)] : model::Move{});
         const bool isRecap = (!pm.isNull() && pm.to() == m.to());
 
-        if (pos.see(m))
+        if (seeGood)
           allowCaptureExt = true;
         else if (isRecap)
           allowCaptureExt = true;
@@ -1591,7 +1416,7 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
 
     // PVS / LMR
     if (moveCount == 0) {
-      value = -negamax(pos, newDepth, -beta, -alpha, ply + 1, childBest, -staticEval);
+      value = -negamax<NT>(pos, newDepth, -beta, -alpha, ply + 1, childBest, -staticEval);
     } else {
       if (cfg.useLMR && isQuiet && !tacticalQuiet && !inCheck && !givesCheck && newDepth >= 2 &&
           moveCount >= 3) {
@@ -1631,9 +1456,11 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
       }
 
       value =
-          -negamax(pos, newDepth - reduction, -alpha - 1, -alpha, ply + 1, childBest, -staticEval);
-      if (value > alpha && value < beta) {
-        value = -negamax(pos, newDepth, -beta, -alpha, ply + 1, childBest, -staticEval);
+          -negamax<NonPV>(pos, newDepth - reduction, -alpha - 1, -alpha, ply + 1, childBest,
+                          -staticEval);
+      // Im NonPV-Knoten gibt es kein alpha < value < beta – die Re-Search entfällt dort ganz
+      if (isPV && value > alpha && value < beta) {
+        value = -negamax<PV>(pos, newDepth, -beta, -alpha, ply + 1, childBest, -staticEval);
       }
     }
 
@@ -1692,11 +1519,13 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
 
   // --- 5) Early ProbCut pass (cheap capture-only skim) ---
   if (!isPV && !inCheck && depth >= 6) {
-    constexpr int PC_MARGIN = 192;        // a bit lighter than in-node 224
-    const int MAX_SCAN = std::min(n, 6);  // don't scan too many
+    constexpr int PC_MARGIN = 192;  // a bit lighter than in-node 224
+    constexpr int MAX_SCAN = 6;     // don't scan too many
 
-    for (int idx = 0; idx < MAX_SCAN; ++idx) {
-      const model::Move m = ordered[idx];
+    SearchMovePicker pc(pos, mg, ord, SearchMovePicker::Mode::ProbCut,
+                        haveTT ? ttMove : model::Move{});
+    int scanned = 0;
+    for (model::Move m; scanned < MAX_SCAN && pc.next(m); ++scanned) {
       if (!m.isCapture()) continue;
       if (mvv_lva_fast(pos, m) < 500) continue;  // need a meaningful tactical swing
 
@@ -1706,7 +1535,7 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
       const int childSE = signed_eval(pos);  // opponent POV
       if (-childSE + PC_MARGIN >= beta) {    // flip the sign
         model::Move tmp{};
-        const int probe = -negamax(pos, depth - 3, -beta, -(beta - 1), ply + 1, tmp, INF);
+        const int probe = -negamax<NonPV>(pos, depth - 3, -beta, -(beta - 1), ply + 1, tmp, INF);
         pcg.rollback();
         if (probe >= beta) return beta;
       } else {
@@ -1724,14 +1553,16 @@ int Search::negamax(model::Position& pos, int depth, int alpha, int beta, int pl
 
   // safety: never leave node without searching at least one move (non-check)
   if (!searchedAny) {
+    const int n = inCheck ? gen_evasions(mg, pos, genArr_[kply], engine::MAX_MOVES)
+                          : gen_all(mg, pos, genArr_[kply], engine::MAX_MOVES);
     for (int idx = 0; idx < n; ++idx) {
-      const model::Move m = ordered[idx];
+      const model::Move m = genArr_[kply][idx];
       if (excludedMove && m == *excludedMove) continue;
       MoveUndoGuard g(pos);
       if (!g.doMove(m)) continue;
 
       model::Move childBest{};
-      int value = -negamax(pos, depth - 1, -beta, -alpha, ply + 1, childBest, -staticEval);
+      int value = -negamax<NT>(pos, depth - 1, -beta, -alpha, ply + 1, childBest, -staticEval);
       value = std::clamp(value, -MATE + 1, MATE - 1);
 
       best = value;
@@ -1792,6 +1623,7 @@ std::vector<model::Move> Search::build_pv_from_tt(model::Position pos, int max_l
 int Search::search_root_single(model::Position& pos, int maxDepth,
                                std::shared_ptr<std::atomic<bool>> stop, std::uint64_t maxNodes) {
   NodeFlushGuard node_guard(sharedNodes);  // <- ensures the final <TICK_STEP> gets counted
+  using enum NodeType;
   // --- init shared stop/nodes ---
   this->stopFlag = stop;
   if (!this->sharedNodes) this->sharedNodes = std::make_shared<std::atomic<std::uint64_t>>(0);
@@ -1808,22 +1640,42 @@ int Search::search_root_single(model::Position& pos, int maxDepth,
     stats.elapsedMs = ms;
     stats.nps = (ms ? (double)stats.nodes / (ms / 1000.0) : (double)stats.nodes);
   };
+  // currmove erst nach ein paar Sekunden, sonst flutet es die GUI
+  constexpr std::uint64_t CURRMOVE_AFTER_MS = 3000;
+  auto elapsed_ms = [&] {
+    return (std::uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               steady_clock::now() - t0)
+        .count();
+  };
+
+  // Iterationsergebnis als UCI "info" (bei MultiPV einmal je Slot)
+  auto report_line = [&](int depth, int multipv, int score, const std::vector<model::Move>& pv) {
+    if (!infoCb_) return;
+    SearchInfo si;
+    si.depth = depth;
+    si.seldepth = std::max(selDepth_, depth);
+    si.score = score;
+    si.nodes = stats.nodes;
+    si.nps = static_cast<std::uint64_t>(stats.nps);
+    si.timeMs = stats.elapsedMs;
+    si.hashfull = tt.hashfull();
+    si.multipv = multipv;
+    si.pv = pv;
+    infoCb_(si);
+  };
 
   try {
     // --- legalize root moves once ---
     std::vector<model::Move> rootMoves;
-    mg.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), rootMoves);
-    if (!rootMoves.empty()) {
-      std::vector<model::Move> legalRoot;
-      legalRoot.reserve(rootMoves.size());
-      for (const auto& m : rootMoves) {
-        MoveUndoGuard guard(pos);
-        if (guard.doMove(m)) {
-          legalRoot.push_back(m);
-          guard.rollback();
-        }
-      }
-      rootMoves.swap(legalRoot);
+    mg.generateLegalMoves(pos.getBoard(), pos.getState(), rootMoves);
+    // go searchmoves: nur diese Wurzelzüge; passt keiner (illegal/fremd), alle legalen
+    if (!limits_.searchMoves.empty()) {
+      std::vector<model::Move> picked;
+      for (const auto& m : rootMoves)
+        if (std::find(limits_.searchMoves.begin(), limits_.searchMoves.end(), m) !=
+            limits_.searchMoves.end())
+          picked.push_back(m);
+      if (!picked.empty()) rootMoves.swap(picked);
     }
     if (rootMoves.empty()) {
       stats.nodes = flush_node_batch(sharedNodes);
@@ -1901,6 +1753,12 @@ int Search::search_root_single(model::Position& pos, int maxDepth,
       int ordIdx = 0;  // stable order index
       bool exactFull = false;
     };
+    // Ergebnis eines MultiPV-Slots einer fertigen Iteration
+    struct PvLine {
+      model::Move m{};
+      int score = 0;
+      std::vector<model::Move> pv;
+    };
 
     // aspiration seed
     int lastScore = 0;
@@ -1912,10 +1770,22 @@ int Search::search_root_single(model::Position& pos, int maxDepth,
     model::Move prevBest{};
     const int maxD = std::max(1, maxDepth);
 
+    // MultiPV: Slot k sucht nur rootMoves[k..] – die schon gemeldeten Züge stehen davor und
+    // werden übersprungen, statt N getrennte Suchen zu starten.
+    const int multiPV = std::clamp(cfg.multiPV, 1, (int)rootMoves.size());
+    std::vector<PvLine> prevLines;  // Slots der letzten fertigen Iteration (Hint + Aspiration)
+
+    // Knoten je Root-Zug (from*64+to) der laufenden Iteration, für den TimeManager
+    std::vector<std::uint64_t> rootNodes(SQ_NB * SQ_NB, 0);
+    std::uint64_t iterNodes = 0;
+
     for (int depth = 1; depth <= maxD; ++depth) {
       if (stop && stop->load(std::memory_order_relaxed)) break;
 
       if (depth > 1) decay_tables(*this, /*shift=*/6);
+      selDepth_ = 0;
+      std::fill(rootNodes.begin(), rootNodes.end(), 0);
+      iterNodes = 0;
 
       // TT move only as soft hint
       model::Move ttMove{};
@@ -1941,233 +1811,314 @@ int Search::search_root_single(model::Position& pos, int maxDepth,
       });
       for (std::size_t i = 0; i < scored.size(); ++i) rootMoves[i] = scored[i].m;
 
-      // push previous best to front for stability
-      if (prevBest.from() != prevBest.to()) {
-        auto it = std::find(rootMoves.begin(), rootMoves.end(), prevBest);
-        if (it != rootMoves.end()) std::rotate(rootMoves.begin(), it, it + 1);
-      }
+      std::vector<PvLine> pvLines;
+      pvLines.reserve(multiPV);
 
-      // aspiration window
-      int alphaTarget = -INF + 1, betaTarget = INF - 1;
-      int window = 24;
-      if (cfg.useAspiration && depth >= 3 && !is_mate_score(lastScore)) {
-        window = std::max(12, cfg.aspirationWindow);
-        alphaTarget = lastScore - window;
-        betaTarget = lastScore + window;
-      }
+      for (int pvIdx = 0; pvIdx < multiPV; ++pvIdx) {
+        const auto slotBegin = rootMoves.begin() + pvIdx;
 
-      int bestScore = -INF;
-      model::Move bestMove{};
+        // push previous best (of this slot) to front for stability
+        model::Move slotPrev = prevBest;
+        if (pvIdx > 0) {
+          slotPrev = pvIdx < (int)prevLines.size() ? prevLines[pvIdx].m : model::Move{};
+        }
+        if (slotPrev.from() != slotPrev.to()) {
+          auto it = std::find(slotBegin, rootMoves.end(), slotPrev);
+          if (it != rootMoves.end()) std::rotate(slotBegin, it, it + 1);
+        }
 
-      while (true) {
-        if (stop && stop->load(std::memory_order_relaxed)) break;
+        // aspiration window
+        const bool haveSeed = pvIdx == 0 || pvIdx < (int)prevLines.size();
+        const int seedScore = pvIdx == 0 ? lastScore : (haveSeed ? prevLines[pvIdx].score : 0);
+        int alphaTarget = -INF + 1, betaTarget = INF - 1;
+        int window = 24;
+        if (cfg.useAspiration && depth >= 3 && haveSeed && !is_mate_score(seedScore)) {
+          window = std::max(12, cfg.aspirationWindow);
+          alphaTarget = seedScore - window;
+          betaTarget = seedScore + window;
+        }
 
-        int alpha = alphaTarget, beta = betaTarget;
-        std::vector<RootLine> lines;
-        lines.reserve(rootMoves.size());
+        int bestScore = -INF;
+        model::Move bestMove{};
+        bool slotDone = false;
 
-        int moveIdx = 0;
-        for (const auto& m : rootMoves) {
+        while (true) {
           if (stop && stop->load(std::memory_order_relaxed)) break;
 
-          const bool isQuietRoot = !m.isCapture() && (m.promotion() == core::PieceType::None);
-          const QuietSignals rootSignals =
-              isQuietRoot ? compute_quiet_signals(pos, m) : QuietSignals{};
-          const bool quietCheckRoot = isQuietRoot && rootSignals.givesCheck;
-          bool pawnQuietCheckRoot = false;
-          if (quietCheckRoot) {
-            if (auto mover = pos.getBoard().getPiece(m.from());
-                mover && mover->type == core::PieceType::Pawn) {
-              pawnQuietCheckRoot = true;
+          int alpha = alphaTarget, beta = betaTarget;
+          std::vector<RootLine> lines;
+          lines.reserve(rootMoves.size() - pvIdx);
+
+          int moveIdx = 0;
+          for (auto mit = slotBegin; mit != rootMoves.end(); ++mit) {
+            const model::Move& m = *mit;
+            if (stop && stop->load(std::memory_order_relaxed)) break;
+
+            const bool isQuietRoot = !m.isCapture() && (m.promotion() == core::PieceType::None);
+            const QuietSignals rootSignals =
+                isQuietRoot ? compute_quiet_signals(pos, m) : QuietSignals{};
+            const bool quietCheckRoot = isQuietRoot && rootSignals.givesCheck;
+            bool pawnQuietCheckRoot = false;
+            if (quietCheckRoot) {
+              if (auto mover = pos.getBoard().getPiece(m.from());
+                  mover && mover->type == core::PieceType::Pawn) {
+                pawnQuietCheckRoot = true;
+              }
             }
-          }
 
-          MoveUndoGuard rg(pos);
-          if (!rg.doMove(m)) {
-            ++moveIdx;
-            continue;
-          }
-          tt.prefetch(pos.hash());
-
-          model::Move childBest{};
-          int s;
+            if (infoCb_) {
+              if (const auto ms = elapsed_ms(); ms >= CURRMOVE_AFTER_MS) {
+                SearchInfo ci;
+                ci.depth = depth;
+                ci.currmove = m;
+                ci.currmoveNumber = pvIdx + moveIdx + 1;
+                ci.nodes = sharedNodes ? sharedNodes->load(std::memory_order_relaxed) : 0;
+                ci.timeMs = ms;
+                infoCb_(ci);
+              }
+            }
 
-          if (moveIdx == 0) {
-            // full window for first (PVS root)
-            s = -negamax(pos, depth - 1, -beta, -alpha, 1, childBest, INF);
-          } else {
-            // Root Move Reductions (light) + PVS
-            int r = 0;
-            const bool rootIsCapture = m.isCapture();
-            const bool rootIsPromo = (m.promotion() != core::PieceType::None);
-            if (rootIsCapture || rootIsPromo)
-              r = 0;  // never reduce tactical roots
-            else if (depth >= 6) {
-              int hist = history[m.from()][m.to()];
-              bool isQuietRoot = !m.isCapture() && (m.promotion() == core::PieceType::None);
-
-              // Base reduction for later root moves
-              if (isQuietRoot) r = 1;
-              if (depth >= 10) r++;
-              if (moveIdx >= 3) r++;
-              if (hist < 0) r++;
-
-              // Slight preference for quiet checks: reduce one step less, but never to zero just
-              // because it checks
-              if (isQuietRoot && quietCheckRoot) r = std::max(0, r - 1);
-
-              if (depth <= 7) r = std::max(0, r - 1);
-              r = std::clamp(r, 0, depth - 2);
+            prefetch_child(pos, m);
+            MoveUndoGuard rg(pos);
+            if (!rg.doMove(m)) {
+              ++moveIdx;
+              continue;
             }
 
-            if (r > 0) {
-              s = -negamax(pos, (depth - 1) - r, -(alpha + 1), -alpha, 1, childBest, INF);
-              if (s > alpha) {
-                s = -negamax(pos, depth - 1, -(alpha + 1), -alpha, 1, childBest, INF);
+            model::Move childBest{};
+            int s;
+            const std::uint64_t nodesBefore = node_batch().searched();
+
+            if (moveIdx == 0) {
+              // full window for first (PVS root)
+              s = -negamax<PV>(pos, depth - 1, -beta, -alpha, 1, childBest, INF);
+            } else {
+              // Root Move Reductions (light) + PVS
+              int r = 0;
+              const bool rootIsCapture = m.isCapture();
+              const bool rootIsPromo = (m.promotion() != core::PieceType::None);
+              if (rootIsCapture || rootIsPromo)
+                r = 0;  // never reduce tactical roots
+              else if (depth >= 6) {
+                int hist = history[m.from()][m.to()];
+                bool isQuietRoot = !m.isCapture() && (m.promotion() == core::PieceType::None);
+
+                // Base reduction for later root moves
+                if (isQuietRoot) r = 1;
+                if (depth >= 10) r++;
+                if (moveIdx >= 3) r++;
+                if (hist < 0) r++;
+
+                // Slight preference for quiet checks: reduce one step less, but never to zero just
+                // because it checks
+                if (isQuietRoot && quietCheckRoot) r = std::max(0, r - 1);
+
+                if (depth <= 7) r = std::max(0, r - 1);
+                r = std::clamp(r, 0, depth - 2);
+              }
+
+              if (r > 0) {
+                s = -negamax<NonPV>(pos, (depth - 1) - r, -(alpha + 1), -alpha, 1, childBest, INF);
+                if (s > alpha) {
+                  s = -negamax<NonPV>(pos, depth - 1, -(alpha + 1), -alpha, 1, childBest, INF);
+                  if (s > alpha && s < beta)
+                    s = -negamax<PV>(pos, depth - 1, -beta, -alpha, 1, childBest, INF);
+                }
+              } else {
+                s = -negamax<NonPV>(pos, depth - 1, -(alpha + 1), -alpha, 1, childBest, INF);
                 if (s > alpha && s < beta)
-                  s = -negamax(pos, depth - 1, -beta, -alpha, 1, childBest, INF);
+                  s = -negamax<PV>(pos, depth - 1, -beta, -alpha, 1, childBest, INF);
               }
-            } else {
-              s = -negamax(pos, depth - 1, -(alpha + 1), -alpha, 1, childBest, INF);
-              if (s > alpha && s < beta)
-                s = -negamax(pos, depth - 1, -beta, -alpha, 1, childBest, INF);
             }
-          }
-
-          s = std::clamp(s, -MATE + 1, MATE - 1);
-          model::Bound b = model::Bound::Exact;
-          if (s <= alpha)
-            b = model::Bound::Upper;
-          else if (s >= beta)
-            b = model::Bound::Lower;
-
-          lines.push_back(RootLine{m, s, b, moveIdx, /*exactFull*/ false});
 
-          if (s > bestScore) {
-            bestScore = s;
-            bestMove = m;
-          }
-          if (s > alpha) alpha = s;
+            const std::uint64_t moveNodes = node_batch().searched() - nodesBefore;
+            rootNodes[m.from() * SQ_NB + m.to()] += moveNodes;
+            iterNodes += moveNodes;
 
-          rg.rollback();
-          ++moveIdx;
-          if (alpha >= beta) break;
-        }
+            s = std::clamp(s, -MATE + 1, MATE - 1);
+            model::Bound b = model::Bound::Exact;
+            if (s <= alpha)
+              b = model::Bound::Upper;
+            else if (s >= beta)
+              b = model::Bound::Lower;
 
-        // success if inside window
-        if (bestScore > alphaTarget && bestScore < betaTarget) {
-          auto full_rescore = [&](RootLine& rl) {
-            MoveUndoGuard rg(pos);
-            if (!rg.doMove(rl.m)) return;
-            model::Move dummy{};
-            int exact = -negamax(pos, depth - 1, -INF + 1, INF - 1, 1, dummy, INF);
-            rl.score = std::clamp(exact, -MATE + 1, MATE - 1);
-            rl.bound = model::Bound::Exact;
-            rl.exactFull = true;
-          };
+            lines.push_back(RootLine{m, s, b, moveIdx, /*exactFull*/ false});
 
-          for (auto& rl : lines)
-            if (rl.m == bestMove) {
-              full_rescore(rl);
-              break;
+            if (s > bestScore) {
+              bestScore = s;
+              bestMove = m;
             }
+            if (s > alpha) alpha = s;
 
-          // Only rescore other moves if cfg.fullRescoreTopK > 1
-          if (cfg.fullRescoreTopK > 1) {
-            std::stable_sort(lines.begin(), lines.end(), [](const RootLine& a, const RootLine& b) {
-              if (a.score != b.score) return a.score > b.score;
-              return a.ordIdx < b.ordIdx;
-            });
-            int rescored = 1;
-            for (auto& rl : lines) {
-              if (rescored >= cfg.fullRescoreTopK) break;
-              if (rl.m == bestMove) continue;
-              full_rescore(rl);
-              ++rescored;
+            rg.rollback();
+            ++moveIdx;
+            if (alpha >= beta) break;
+          }
+
+          // success if inside window
+          if (bestScore > alphaTarget && bestScore < betaTarget && pvIdx > 0) {
+            // weitere Slots: innerhalb des Fensters ist der PVS-Score schon exakt
+            PvLine line{bestMove, bestScore, {}};
+            model::Position tmp = pos;
+            if (tmp.doMove(bestMove)) {
+              line.pv.push_back(bestMove);
+              auto rest = build_pv_from_tt(tmp, 32);
+              line.pv.insert(line.pv.end(), rest.begin(), rest.end());
             }
+            pvLines.push_back(std::move(line));
+            slotDone = true;
+            break;
           }
+          if (bestScore > alphaTarget && bestScore < betaTarget) {
+            auto full_rescore = [&](RootLine& rl) {
+              MoveUndoGuard rg(pos);
+              if (!rg.doMove(rl.m)) return;
+              model::Move dummy{};
+              int exact = -negamax<PV>(pos, depth - 1, -INF + 1, INF - 1, 1, dummy, INF);
+              rl.score = std::clamp(exact, -MATE + 1, MATE - 1);
+              rl.bound = model::Bound::Exact;
+              rl.exactFull = true;
+            };
+
+            for (auto& rl : lines)
+              if (rl.m == bestMove) {
+                full_rescore(rl);
+                break;
+              }
 
-          // pick final best (exact first, then score, then ordIdx)
-          auto rank_bound = [](model::Bound b) {
-            switch (b) {
-              case model::Bound::Exact:
-              case model::Bound::Lower:
-                return 2;
-              case model::Bound::Upper:
-              default:
-                return 1;
+            // Only rescore other moves if cfg.fullRescoreTopK > 1
+            if (cfg.fullRescoreTopK > 1) {
+              std::stable_sort(lines.begin(), lines.end(),
+                               [](const RootLine& a, const RootLine& b) {
+                                 if (a.score != b.score) return a.score > b.score;
+                                 return a.ordIdx < b.ordIdx;
+                               });
+              int rescored = 1;
+              for (auto& rl : lines) {
+                if (rescored >= cfg.fullRescoreTopK) break;
+                if (rl.m == bestMove) continue;
+                full_rescore(rl);
+                ++rescored;
+              }
             }
-          };
-          std::stable_sort(lines.begin(), lines.end(), [&](const RootLine& a, const RootLine& b) {
-            const int ra = rank_bound(a.bound), rb = rank_bound(b.bound);
-            if (ra != rb) return ra > rb;
-            if (a.score != b.score) return a.score > b.score;
-            return a.ordIdx < b.ordIdx;
-          });
-
-          if (!lines.empty() && lines.front().bound != model::Bound::Exact) {
-            full_rescore(lines.front());
+
+            // pick final best (exact first, then score, then ordIdx)
+            auto rank_bound = [](model::Bound b) {
+              switch (b) {
+                case model::Bound::Exact:
+                case model::Bound::Lower:
+                  return 2;
+                case model::Bound::Upper:
+                default:
+                  return 1;
+              }
+            };
             std::stable_sort(lines.begin(), lines.end(), [&](const RootLine& a, const RootLine& b) {
               const int ra = rank_bound(a.bound), rb = rank_bound(b.bound);
               if (ra != rb) return ra > rb;
               if (a.score != b.score) return a.score > b.score;
               return a.ordIdx < b.ordIdx;
             });
-          }
 
-          const model::Move finalBest = lines.front().m;
-          const int finalScore = lines.front().score;
+            if (!lines.empty() && lines.front().bound != model::Bound::Exact) {
+              full_rescore(lines.front());
+              std::stable_sort(lines.begin(), lines.end(),
+                               [&](const RootLine& a, const RootLine& b) {
+                                 const int ra = rank_bound(a.bound), rb = rank_bound(b.bound);
+                                 if (ra != rb) return ra > rb;
+                                 if (a.score != b.score) return a.score > b.score;
+                                 return a.ordIdx < b.ordIdx;
+                               });
+            }
 
-          // stats & PV
-          stats.nodes = flush_node_batch(sharedNodes);
-          update_time_stats();
+            const model::Move finalBest = lines.front().m;
+            const int finalScore = lines.front().score;
 
-          stats.bestScore = finalScore;
-          stats.bestMove = finalBest;
-          prevBest = finalBest;
+            // stats & PV
+            stats.nodes = flush_node_batch(sharedNodes);
+            update_time_stats();
 
-          stats.bestPV.clear();
-          {
-            model::Position tmp = pos;
-            if (tmp.doMove(finalBest)) {
-              stats.bestPV.push_back(finalBest);
-              auto rest = build_pv_from_tt(tmp, 32);
-              for (auto& mv : rest) stats.bestPV.push_back(mv);
+            stats.bestScore = finalScore;
+            stats.bestMove = finalBest;
+            prevBest = finalBest;
+
+            stats.bestPV.clear();
+            {
+              model::Position tmp = pos;
+              if (tmp.doMove(finalBest)) {
+                stats.bestPV.push_back(finalBest);
+                auto rest = build_pv_from_tt(tmp, 32);
+                for (auto& mv : rest) stats.bestPV.push_back(mv);
+              }
             }
-          }
 
-          // build exact-only topMoves (best first)
-          stats.topMoves.clear();
-          stats.topMoves.push_back({finalBest, finalScore});
-          for (const auto& rl : lines) {
-            if ((int)stats.topMoves.size() >= 5) break;
-            if (rl.m == finalBest) continue;
-            if (rl.bound == model::Bound::Exact) stats.topMoves.push_back({rl.m, rl.score});
+            // build exact-only topMoves (best first)
+            stats.topMoves.clear();
+            stats.topMoves.push_back({finalBest, finalScore});
+            for (const auto& rl : lines) {
+              if ((int)stats.topMoves.size() >= 5) break;
+              if (rl.m == finalBest) continue;
+              if (rl.bound == model::Bound::Exact) stats.topMoves.push_back({rl.m, rl.score});
+            }
+            if (stats.topMoves.size() > 1) {
+              std::stable_sort(stats.topMoves.begin() + 1, stats.topMoves.end(),
+                               [](const auto& a, const auto& b) { return a.second > b.second; });
+            }
+
+            pvLines.push_back(PvLine{finalBest, finalScore, stats.bestPV});
+            if (multiPV == 1) report_line(depth, 1, finalScore, stats.bestPV);
+
+            slotDone = true;
+            break;  // slot done
           }
-          if (stats.topMoves.size() > 1) {
-            std::stable_sort(stats.topMoves.begin() + 1, stats.topMoves.end(),
-                             [](const auto& a, const auto& b) { return a.second > b.second; });
+
+          // widen window
+          if (bestScore <= alphaTarget) {
+            int step = std::max(32, window);
+            alphaTarget = std::max(-INF + 1, alphaTarget - step);
+            window += step / 2;
+          } else if (bestScore >= betaTarget) {
+            int step = std::max(32, window);
+            betaTarget = std::min(INF - 1, betaTarget + step);
+            window += step / 2;
+          } else {
+            break;  // shouldn't happen
           }
+        }  // aspiration loop
 
-          break;  // depth done
+        if (!slotDone) break;
+        // gemeldeten Zug vor die restlichen Slots stellen
+        if (pvIdx + 1 < multiPV) {
+          auto it = std::find(slotBegin, rootMoves.end(), pvLines.back().m);
+          if (it != rootMoves.end()) std::rotate(slotBegin, it, it + 1);
         }
-
-        // widen window
-        if (bestScore <= alphaTarget) {
-          int step = std::max(32, window);
-          alphaTarget = std::max(-INF + 1, alphaTarget - step);
-          window += step / 2;
-        } else if (bestScore >= betaTarget) {
-          int step = std::max(32, window);
-          betaTarget = std::min(INF - 1, betaTarget + step);
-          window += step / 2;
-        } else {
-          break;  // shouldn't happen
+      }  // MultiPV slots
+
+      if (multiPV > 1 && (int)pvLines.size() == multiPV) {
+        stats.nodes = flush_node_batch(sharedNodes);
+        update_time_stats();
+        stats.topMoves.clear();
+        for (int k = 0; k < multiPV; ++k) {
+          stats.topMoves.push_back({pvLines[k].m, pvLines[k].score});
+          report_line(depth, k + 1, pvLines[k].score, pvLines[k].pv);
         }
-      }  // aspiration loop
+        prevLines = std::move(pvLines);
+      }
 
-      if (is_mate_score(stats.bestScore)) break;
+      if (is_mate_score(stats.bestScore)) {
+        // go mate N: nur ein eigenes Matt in höchstens N Zügen beendet die Suche vorzeitig
+        if (limits_.mate <= 0) break;
+        if (stats.bestScore > 0 && (MATE - stats.bestScore + 1) / 2 <= limits_.mate) break;
+      }
       lastScore = stats.bestScore;
+
+      // Soft-Limit: stabiler, klarer Zug -> früher aufhören; Wechsel/fallender Score -> länger
+      if (timeMgr_ && stats.bestMove && !(stop && stop->load(std::memory_order_relaxed))) {
+        const model::Move bm = *stats.bestMove;
+        const double frac =
+            iterNodes ? (double)rootNodes[bm.from() * SQ_NB + bm.to()] / (double)iterNodes : 1.0;
+        if (timeMgr_->stop_after_iteration(bm, stats.bestScore, frac)) break;
+      }
     }  // depth loop
 
     stats.nodes = flush_node_batch(sharedNodes);
@@ -2188,71 +2139,46 @@ int Search::search_root_single(model::Position& pos, int maxDepth,
 }
 
 int Search::search_root_lazy_smp(model::Position& pos, int maxDepth,
-                                 std::shared_ptr<std::atomic<bool>> stop, int maxThreads,
+                                 std::shared_ptr<std::atomic<bool>> stop, SearchThreads& helpers,
                                  std::uint64_t maxNodes) {
-  const int threads = std::max(1, maxThreads > 0 ? std::min(maxThreads, cfg.threads) : cfg.threads);
   // Eine gemeinsame TT-Generation
   try {
     tt.new_generation();
   } catch (...) {
   }
+  tt.reset_stats();
 
-  if (threads <= 1) return search_root_single(pos, maxDepth, stop, maxNodes);
-
-  auto& pool = ThreadPool::instance();
+  // frischer Zähler, sonst summieren sich die Knoten über alle Suchen der Session
   auto sharedCounter = std::make_shared<std::atomic<std::uint64_t>>(0);
-  sharedCounter->store(0, std::memory_order_relaxed);  // reset once, up front
-  const auto smpStart = steady_clock::now();
-
-  std::vector<std::unique_ptr<Search>> workers;
-  workers.reserve(threads);
-  for (int t = 0; t < threads; ++t) {
-    auto w = std::make_unique<Search>(tt, eval_, cfg);
-    w->set_thread_id(t);
-    w->stopFlag = stop;
-    w->set_node_limit(sharedCounter, maxNodes);
-    // Heuristiken aus dem Main übernehmen: weniger Driften, bessere Order-Kohärenz
-    w->copy_heuristics_from(*this);
-    workers.emplace_back(std::move(w));
-  }
-  for (auto& w : workers) w->stopFlag = stop;
   this->set_node_limit(sharedCounter, maxNodes);
 
-  int mainScore = 0;
-
-  // Snapshot der Ausgangsstellung anlegen, bevor Helfer starten
-  const model::Position rootSnapshot = pos;
-
-  // Helfer starten
-  std::vector<std::future<int>> futs;
-  futs.reserve(threads - 1);
-  for (int t = 1; t < threads; ++t) {
-    futs.emplace_back(pool.submit([rootSnapshot, &workers, maxDepth, stop, tid = t] {
-      model::Position local = rootSnapshot;
-      // Helfer: Root-Ordering möglichst nicht vom TT-Move abhängig machen,
-      // damit Main deterministischer bleibt (optional: cfg-Flag verwenden).
-      return workers[tid]->search_root_single(local, maxDepth, stop, /*maxNodes*/ 0);
-    }));
+  if (helpers.size() == 0) {
+    const int score = search_root_single(pos, maxDepth, stop, maxNodes);
+    this->stats.hashfull = tt.hashfull();
+    this->stats.tt = tt.stats();
+    return score;
   }
 
-  // Main sucht & liefert Ergebnis
-  mainScore = this->search_root_single(pos, maxDepth, stop, /*maxNodes*/ 0);
+  // Helfer brauchen ein Stop-Signal, auch wenn der Aufrufer keins mitgibt
+  if (!stop) stop = std::make_shared<std::atomic<bool>>(false);
+  const auto smpStart = steady_clock::now();
 
-  // Main ist fertig -> Helfer stoppen
-  if (stop) stop->store(true, std::memory_order_relaxed);
+  // Helfer starten (eigene Threads, eigene Search-Instanzen, eigene Histories)
+  helpers.start(pos, maxDepth, stop, sharedCounter, maxNodes, deadline_, limits_);
 
-  // wait
-  for (auto& f : futs) {
-    try {
-      (void)f.get();
-    } catch (...) {
-    }
+  // Main sucht & liefert Ergebnis
+  int mainScore = 0;
+  try {
+    mainScore = this->search_root_single(pos, maxDepth, stop, maxNodes);
+  } catch (...) {
+    stop->store(true, std::memory_order_relaxed);
+    helpers.wait();
+    throw;
   }
 
-  // NEW: fold worker heuristics back into main
-  for (int t = 1; t < threads; ++t) {
-    this->merge_from(*workers[t]);
-  }
+  // Main ist fertig -> Helfer stoppen
+  stop->store(true, std::memory_order_relaxed);
+  helpers.wait();
 
   // Finalize stats from all threads
   this->stats.nodes = sharedCounter->load(std::memory_order_relaxed);
@@ -2262,6 +2188,8 @@ int Search::search_root_lazy_smp(model::Position& pos, int maxDepth,
   this->stats.elapsedMs = ms_total;
   this->stats.nps =
       (ms_total ? (double)this->stats.nodes / (ms_total / 1000.0) : (double)this->stats.nodes);
+  this->stats.hashfull = tt.hashfull();
+  this->stats.tt = tt.stats();
   return mainScore;
 }
 
@@ -2281,68 +2209,4 @@ void Search::clearSearchState() {
   stats = SearchStats{};
 }
 
-void Search::copy_heuristics_from(const Search& src) {
-  // History-like tables
-  history = src.history;  // std::array copy
-
-  std::memcpy(quietHist, src.quietHist, sizeof(quietHist));
-  std::memcpy(captureHist, src.captureHist, sizeof(captureHist));
-  std::memcpy(counterHist, src.counterHist, sizeof(counterHist));
-  std::memcpy(counterMove, src.counterMove, sizeof(counterMove));
-
-  // Killers nicht kopieren
-  for (auto& kk : killers) {
-    kk[0] = model::Move{};
-    kk[1] = model::Move{};
-  }
-
-  // prevMove buffers sind lokaler Pfad-State
-  for (auto& pm : prevMove) pm = model::Move{};
-}
-
-// EMA merge toward the worker's values: G += (L - G) / K
-static inline int16_t ema_merge(int16_t G, int16_t L, int K) {
-  int d = (int)L - (int)G;
-  return clamp16((int)G + d / K);
-}
-
-void Search::merge_from(const Search& o) {
-  // kleiner K -> schnelleres Lernen
-  constexpr int K = 4;
-
-  // Base history
-  for (int f = 0; f < SQ_NB; ++f)
-    for (int t = 0; t < SQ_NB; ++t) history[f][t] = ema_merge(history[f][t], o.history[f][t], K);
-
-  // Quiet history
-  for (int p = 0; p < PIECE_NB; ++p)
-    for (int t = 0; t < SQ_NB; ++t)
-      quietHist[p][t] = ema_merge(quietHist[p][t], o.quietHist[p][t], K);
-
-  // Capture history
-  for (int mp = 0; mp < PIECE_NB; ++mp)
-    for (int t = 0; t < SQ_NB; ++t)
-      for (int cp = 0; cp < PIECE_NB; ++cp)
-        captureHist[mp][t][cp] = ema_merge(captureHist[mp][t][cp], o.captureHist[mp][t][cp], K);
-
-  // Counter history + best countermove choice
-  for (int f = 0; f < SQ_NB; ++f) {
-    for (int t = 0; t < SQ_NB; ++t) {
-      counterHist[f][t] = ema_merge(counterHist[f][t], o.counterHist[f][t], K);
-      if (o.counterHist[f][t] > counterHist[f][t]) {
-        counterMove[f][t] = o.counterMove[f][t];
-      }
-    }
-  }
-
-  // Continuation History (EMA)
-  for (int L = 0; L < CH_LAYERS; ++L)
-    for (int pp = 0; pp < PIECE_NB; ++pp)
-      for (int pt = 0; pt < SQ_NB; ++pt)
-        for (int mp = 0; mp < PIECE_NB; ++mp)
-          for (int to = 0; to < SQ_NB; ++to)
-            contHist[L][pp][pt][mp][to] =
-                ema_merge(contHist[L][pp][pt][mp][to], o.contHist[L][pp][pt][mp][to], K);
-}
-
 }  // namespace lilia::engine
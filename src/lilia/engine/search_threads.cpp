@@ -0,0 +1,104 @@
+#include "lilia/engine/search_threads.hpp"
+
+#include <algorithm>
+
+#include "lilia/engine/search.hpp"
+
+namespace lilia::engine {
+
+SearchThreads::SearchThreads(model::TT5& tt, std::shared_ptr<const Evaluator> eval,
+                             const EngineConfig& cfg)
+    : tt_(tt), eval_(std::move(eval)), cfg_(cfg) {}
+
+SearchThreads::~SearchThreads() {
+  shutdown();
+}
+
+void SearchThreads::shutdown() {
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    quit_ = true;
+  }
+  startCv_.notify_all();
+  for (auto& w : workers_)
+    if (w.thread.joinable()) w.thread.join();
+}
+
+void SearchThreads::resize(int helpers) {
+  helpers = std::max(0, helpers);
+  wait();
+  if (helpers == size()) return;
+
+  // Threads kurz beenden; die Search-Objekte (und ihre Histories) bleiben erhalten
+  shutdown();
+  if ((int)workers_.size() > helpers) workers_.resize(helpers);
+  while ((int)workers_.size() < helpers) {
+    Worker w;
+    w.search = std::make_unique<Search>(tt_, eval_, cfg_);
+    w.search->set_thread_id((int)workers_.size() + 1);
+    workers_.emplace_back(std::move(w));
+  }
+
+  // Startrunde mitgeben: ein start() direkt nach resize() darf nicht verloren gehen
+  quit_ = false;
+  for (auto& w : workers_)
+    w.thread = std::thread([this, s = w.search.get(), r = round_] { idle_loop(*s, r); });
+}
+
+void SearchThreads::idle_loop(Search& s, std::uint64_t seen) {
+  std::unique_lock<std::mutex> lk(m_);
+  for (;;) {
+    startCv_.wait(lk, [&] { return quit_ || round_ != seen; });
+    if (quit_) return;
+    seen = round_;
+
+    model::Position local = root_;
+    const int depth = maxDepth_;
+    const auto stop = stop_;
+    lk.unlock();
+
+    try {
+      (void)s.search_root_single(local, depth, stop, /*maxNodes*/ 0);
+    } catch (...) {
+      // Helfer-Ergebnisse sind optional; der Main-Thread entscheidet
+    }
+
+    lk.lock();
+    if (--running_ == 0) doneCv_.notify_all();
+  }
+}
+
+void SearchThreads::start(const model::Position& root, int maxDepth,
+                          std::shared_ptr<std::atomic<bool>> stop,
+                          std::shared_ptr<std::atomic<std::uint64_t>> nodes,
+                          std::uint64_t maxNodes, const SearchDeadline& deadline,
+                          const SearchLimits& limits) {
+  if (workers_.empty()) return;
+  wait();
+  {
+    std::lock_guard<std::mutex> lk(m_);
+    root_ = root;
+    maxDepth_ = maxDepth;
+    stop_ = std::move(stop);
+    for (auto& w : workers_) {
+      w.search->set_node_limit(nodes, maxNodes);
+      w.search->set_deadline(deadline);
+      w.search->set_limits(limits);
+    }
+    running_ = size();
+    ++round_;
+  }
+  startCv_.notify_all();
+}
+
+void SearchThreads::wait() {
+  std::unique_lock<std::mutex> lk(m_);
+  doneCv_.wait(lk, [&] { return running_ == 0; });
+}
+
+void SearchThreads::clear() {
+  wait();
+  for (auto& w : workers_) w.search->clearSearchState();
+}
+
+}  // namespace lilia::engine
@@ -0,0 +1,105 @@
+#include "lilia/engine/time_manager.hpp"
+
+#include <algorithm>
+
+namespace lilia::engine {
+
+namespace {
+
+// Ohne movestogo: so viele Züge muss die Restzeit noch reichen
+constexpr int DEFAULT_HORIZON = 30;
+// maximum() darf optimum() höchstens um diesen Faktor überschreiten ...
+constexpr double MAX_OVER_OPTIMUM = 5.0;
+// ... und nie mehr als diesen Anteil der Restzeit nehmen (letzter Zug vor der Kontrolle: 90 %)
+constexpr double MAX_SHARE = 0.4;
+constexpr double MAX_SHARE_LAST = 0.9;
+
+}  // namespace
+
+void TimeManager::start(const TimeLimits& limits) {
+  t0_ = clock::now();
+  deadline_.store(NO_DEADLINE, std::memory_order_relaxed);
+  pondering_.store(limits.ponder);
+  stopOnPonderhit_.store(false);
+  managed_ = fixed_ = false;
+  optimum_ = maximum_ = 0;
+  prevBest_ = model::Move{};
+  bestMoveChanges_ = 0.0;
+  haveScore_ = false;
+  scoreAvg_ = 0.0;
+
+  const int overhead = std::max(0, limits.moveOverhead);
+
+  if (limits.movetime > 0) {
+    managed_ = fixed_ = true;
+    optimum_ = maximum_ = std::max(1, limits.movetime - overhead);
+    if (!limits.ponder) arm_deadline(t0_);
+    return;
+  }
+  if (limits.infinite || limits.timeLeft < 0) return;
+
+  managed_ = true;
+  const int horizon = limits.movestogo > 0 ? limits.movestogo : DEFAULT_HORIZON;
+  const std::int64_t usable =
+      std::max<std::int64_t>(0, (std::int64_t)limits.timeLeft - overhead);
+  const std::int64_t inc = std::max(0, limits.inc);
+
+  const double share = (horizon == 1) ? MAX_SHARE_LAST : MAX_SHARE;
+  const std::int64_t cap = std::max<std::int64_t>(1, (std::int64_t)(usable * share));
+
+  std::int64_t opt = usable / horizon + inc * 3 / 4;
+  opt = std::clamp<std::int64_t>(opt, 1, cap);
+  optimum_ = opt;
+  maximum_ = std::clamp<std::int64_t>((std::int64_t)(opt * MAX_OVER_OPTIMUM), opt, cap);
+  if (!limits.ponder) arm_deadline(t0_);
+}
+
+void TimeManager::arm_deadline(clock::time_point from) {
+  deadline_.store((from + std::chrono::milliseconds(maximum_)).time_since_epoch().count(),
+                  std::memory_order_relaxed);
+}
+
+void TimeManager::ponderhit() {
+  if (!pondering_.exchange(false)) return;
+  if (!managed_) return;
+  const auto now = clock::now();
+  if (stopOnPonderhit_.load()) {
+    deadline_.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+  } else {
+    arm_deadline(now);
+  }
+}
+
+bool TimeManager::stop_after_iteration(const model::Move& best, int score,
+                                       double bestNodeFraction) {
+  if (!managed_ || fixed_) return false;
+
+  // Stabilität: jeder Wechsel zählt 1, ältere Wechsel verlieren pro Iteration die Hälfte
+  const bool changed = prevBest_.from() != prevBest_.to() && !(best == prevBest_);
+  bestMoveChanges_ = bestMoveChanges_ * 0.5 + (changed ? 1.0 : 0.0);
+  prevBest_ = best;
+  const double stability = 0.7 + 0.8 * bestMoveChanges_;
+
+  // Score-Trend gegen den gleitenden Schnitt der bisherigen Iterationen
+  double trend = 1.0;
+  if (haveScore_) {
+    const double drop = scoreAvg_ - (double)score;
+    trend = std::clamp(1.0 + drop / 160.0, 0.85, 1.6);
+    scoreAvg_ = (scoreAvg_ * 3.0 + (double)score) / 4.0;
+  } else {
+    scoreAvg_ = (double)score;
+    haveScore_ = true;
+  }
+
+  // Knotenanteil: bekommt der beste Zug fast den ganzen Baum, ist er klar
+  const double effort = std::clamp(1.6 - 1.1 * bestNodeFraction, 0.55, 1.6);
+
+  const double soft = std::min<double>((double)maximum_, optimum_ * stability * trend * effort);
+  if ((double)elapsed() < soft) return false;
+  if (!pondering()) return true;
+  // Beim Pondern weiterrechnen; kam ponderhit() dazwischen, gilt die Entscheidung doch
+  stopOnPonderhit_.store(true);  // seq_cst: paart sich mit ponderhit()
+  return !pondering();
+}
+
+}  // namespace lilia::engine
@@ -0,0 +1,277 @@
+#include "lilia/log/log.hpp"
+
+#include <bit>
+#include <cctype>
+#include <iostream>
+#include <streambuf>
+#include <utility>
+
+namespace lilia::log {
+
+// ---------- MpscRing ----------
+
+MpscRing::MpscRing(std::size_t capacity) {
+  const std::size_t n = std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity);
+  cells_ = std::make_unique<Cell[]>(n);
+  for (std::size_t i = 0; i < n; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+  mask_ = n - 1;
+}
+
+bool MpscRing::try_push(std::string& text) {
+  std::size_t pos = head_.load(std::memory_order_relaxed);
+  for (;;) {
+    Cell& c = cells_[pos & mask_];
+    const std::size_t seq = c.seq.load(std::memory_order_acquire);
+    const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+    if (diff == 0) {
+      if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        c.text = std::move(text);
+        c.seq.store(pos + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;  // voll: Konsument hat die Zelle noch nicht freigegeben
+    } else {
+      pos = head_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool MpscRing::try_pop(std::string& out) {
+  const std::size_t tail = tail_.load(std::memory_order_relaxed);
+  Cell& c = cells_[tail & mask_];
+  if (c.seq.load(std::memory_order_acquire) != tail + 1) return false;
+  out = std::move(c.text);
+  c.text.clear();
+  c.seq.store(tail + mask_ + 1, std::memory_order_release);
+  tail_.store(tail + 1, std::memory_order_relaxed);
+  return true;
+}
+
+// ---------- Channel ----------
+
+Channel& Channel::instance() {
+  static Channel ch;
+  return ch;
+}
+
+Channel::Channel() : writer_([this] { writer_loop(); }) {}
+
+Channel::~Channel() {
+  quit_.store(true);
+  wakeups_.fetch_add(1);
+  wakeups_.notify_one();
+  if (writer_.joinable()) writer_.join();
+}
+
+void Channel::protocol(std::string text) {
+  if (text.empty()) return;
+  // Protokollzeilen dürfen nicht verloren gehen; voll heißt nur, dass die GUI nicht liest
+  while (!protocol_.try_push(text)) {
+    wake();
+    std::this_thread::yield();
+  }
+  pushed_.fetch_add(1);
+  wake();
+}
+
+void Channel::info(std::string text) {
+  if (text.empty()) return;
+  // Such-Threads warten nie auf die GUI: lieber eine Zwischenstand-Zeile weniger
+  if (protocol_.approx_size() >= INFO_LIMIT || !protocol_.try_push(text)) {
+    infoDropped_.fetch_add(1, std::memory_order_relaxed);
+    wake();
+    return;
+  }
+  pushed_.fetch_add(1);
+  wake();
+}
+
+void Channel::diagnostic(std::string text) {
+  if (text.empty()) return;
+  if (!diagnostic_.try_push(text)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  pushed_.fetch_add(1);
+  wake();
+}
+
+void Channel::wake() {
+  // seq_cst gegen sleeping_/pushed_ im Writer: einer von beiden sieht den anderen
+  if (sleeping_.load()) {
+    wakeups_.fetch_add(1);
+    wakeups_.notify_one();
+  }
+}
+
+void Channel::flush() {
+  const std::uint64_t target = pushed_.load();
+  wake();
+  for (std::uint64_t w = written_.load(); w < target; w = written_.load()) written_.wait(w);
+}
+
+void Channel::writer_loop() {
+  std::string text;
+  for (;;) {
+    std::uint64_t n = 0;
+    if (protocol_.try_pop(text)) {
+      do {
+        std::cout << text;
+        ++n;
+      } while (protocol_.try_pop(text));
+      std::cout.flush();
+    }
+    while (diagnostic_.try_pop(text)) {
+      std::cerr << text;
+      ++n;
+    }
+    if (n) {
+      written_.fetch_add(n);
+      written_.notify_all();
+      continue;
+    }
+    if (quit_.load()) return;
+
+    const std::uint32_t seen = wakeups_.load();
+    sleeping_.store(true);
+    if (pushed_.load() == written_.load() && !quit_.load()) wakeups_.wait(seen);
+    sleeping_.store(false);
+  }
+}
+
+// ---------- diagnostic() ----------
+
+namespace {
+
+// Sammelt bis '\n' und reiht die Zeile dann in den diagnostic-Kanal ein
+class DiagnosticBuf final : public std::streambuf {
+ public:
+  ~DiagnosticBuf() override { sync(); }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+    line_.push_back(traits_type::to_char_type(ch));
+    if (ch == '\n') sync();
+    return ch;
+  }
+  int sync() override {
+    if (!line_.empty()) Channel::instance().diagnostic(std::exchange(line_, {}));
+    return 0;
+  }
+
+ private:
+  std::string line_;
+};
+
+}  // namespace
+
+std::ostream& diagnostic() {
+  thread_local DiagnosticBuf buf;
+  thread_local std::ostream os(&buf);
+  return os;
+}
+
+// ---------- Level / Kategorien ----------
+
+namespace {
+
+constexpr Category ALL_CATS[] = {Category::General, Category::Search, Category::Uci,
+                                 Category::TT, Category::Time};
+
+std::string lower(std::string_view s) {
+  std::string out(s);
+  for (auto& c : out) c = (char)std::tolower((unsigned char)c);
+  return out;
+}
+
+}  // namespace
+
+const char* level_name(Level lv) {
+  switch (lv) {
+    case Level::Off:
+      return "off";
+    case Level::Error:
+      return "error";
+    case Level::Warn:
+      return "warn";
+    case Level::Info:
+      return "info";
+    case Level::Debug:
+      return "debug";
+  }
+  return "?";
+}
+
+const char* category_name(Category cat) {
+  switch (cat) {
+    case Category::General:
+      return "general";
+    case Category::Search:
+      return "search";
+    case Category::Uci:
+      return "uci";
+    case Category::TT:
+      return "tt";
+    case Category::Time:
+      return "time";
+  }
+  return "?";
+}
+
+bool parse_level(std::string_view s, Level& out) {
+  const std::string v = lower(s);
+  for (Level lv : {Level::Off, Level::Error, Level::Warn, Level::Info, Level::Debug}) {
+    if (v == level_name(lv)) {
+      out = lv;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parse_categories(std::string_view s, std::uint32_t& out) {
+  const std::string v = lower(s);
+  if (v == "all") {
+    out = ALL_CATEGORIES;
+    return true;
+  }
+  if (v == "none") {
+    out = 0;
+    return true;
+  }
+  std::uint32_t mask = 0;
+  std::size_t start = 0;
+  while (start <= v.size()) {
+    std::size_t end = v.find_first_of(", ", start);
+    if (end == std::string::npos) end = v.size();
+    const std::string tok = v.substr(start, end - start);
+    if (!tok.empty()) {
+      bool known = false;
+      for (Category c : ALL_CATS) {
+        if (tok == category_name(c)) {
+          mask |= static_cast<std::uint32_t>(c);
+          known = true;
+        }
+      }
+      if (!known) return false;
+    }
+    start = end + 1;
+  }
+  out = mask;
+  return true;
+}
+
+// ---------- Line ----------
+
+Line::Line(Level lv, Category cat) {
+  os_ << '[' << category_name(cat) << ':' << level_name(lv) << "] ";
+}
+
+Line::~Line() {
+  os_ << '\n';
+  Channel::instance().diagnostic(os_.str());
+}
+
+}  // namespace lilia::log
@@ -48,7 +48,6 @@ inline int parseInt(std::string_view sv) noexcept {
 // ---------------- Public API ----------------
 
 ChessGame::ChessGame() {
-  m_pseudo_moves.reserve(256);
   m_legal_moves.reserve(256);
 }
 
@@ -96,7 +95,6 @@ void ChessGame::setPosition(const std::string& fen) {
   // full reset
   m_position = Position{};
   m_result = core::GameResult::ONGOING;
-  m_pseudo_moves.clear();
   m_legal_moves.clear();
 
   // Split FEN into 6 fields manually (faster than stringstream)
@@ -217,9 +215,10 @@ void ChessGame::setPosition(const std::string& fen) {
   m_position.getState().halfmoveClock = hm;
   m_position.getState().fullmoveNumber = fm;
 
-  // Rebuild hashes/accumulators
+  // Rebuild hashes/accumulators/check info
   m_position.buildHash();
   m_position.rebuildEvalAcc();
+  m_position.buildCheckInfo();
 }
 
 void ChessGame::buildHash() {
@@ -227,18 +226,8 @@ void ChessGame::buildHash() {
 }
 
 const std::vector<Move>& ChessGame::generateLegalMoves() {
-  m_pseudo_moves.clear();
-  m_legal_moves.clear();
-
-  m_move_gen.generatePseudoLegalMoves(m_position.getBoard(), m_position.getState(), m_pseudo_moves);
-
-  // Filter legality by make/unmake (fast because Position has fast quiet paths)
-  for (const auto& m : m_pseudo_moves) {
-    if (m_position.doMove(m)) {
-      m_position.undoMove();
-      m_legal_moves.push_back(m);
-    }
-  }
+  // Generator liefert direkt legale Züge (Fesselungen/Schach schon berücksichtigt)
+  m_move_gen.generateLegalMoves(m_position.getBoard(), m_position.getState(), m_legal_moves);
   return m_legal_moves;
 }
 
@@ -287,17 +276,11 @@ bb::Piece ChessGame::getPiece(core::Square sq) {
   return opt.value_or(bb::Piece{core::PieceType::None, core::Color::White});
 }
 
+// Prüft nur diesen einen Zug (isPseudoLegal + doMove verwirft Selbstschach), statt die
+// komplette Liste legaler Züge zu erzeugen – wichtig für lange "position ... moves".
 bool ChessGame::doMove(core::Square from, core::Square to, core::PieceType promotion) {
-  const auto& moves = generateLegalMoves();
-  for (const auto& m : moves) {
-    if (m.from() == from && m.to() == to && m.promotion() == promotion) {
-      if (m_position.doMove(m)) {
-        return true;
-      }
-      break;  // execute once
-    }
-  }
-  return false;
+  const auto m = m_position.resolveMove(Move(from, to, promotion));
+  return m && m_position.doMove(*m);
 }
 
 bool ChessGame::isKingInCheck(core::Color from) const {
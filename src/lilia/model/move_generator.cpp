@@ -1,6 +1,5 @@
 #include "lilia/model/move_generator.hpp"
 
-#include <array>
 #include <cassert>
 #include <cstdint>
 
@@ -38,41 +37,8 @@ LILIA_ALWAYS_INLINE SideSets side_sets(const Board& b, Color c) noexcept {
   return SideSets{pawns, knights, bishops, rooks, queens, king, all, all & ~king};
 }
 
-// ---------------- Between table ----------------
-
-constexpr bb::Bitboard compute_between_single(int ai, int bi) noexcept {
-  if (ai == bi) return 0ULL;
-  const int d = bi - ai;
-  const int ar = ai / 8, br = bi / 8;
-  const int af = ai % 8, bf = bi % 8;
-  int step = 0;
-  if (ar == br)
-    step = (d > 0 ? 1 : -1);
-  else if (af == bf)
-    step = (d > 0 ? 8 : -8);
-  else if (d % 9 == 0 && (br - ar) == (bf - af))
-    step = (d > 0 ? 9 : -9);
-  else if (d % 7 == 0 && (br - ar) == (af - bf))
-    step = (d > 0 ? 7 : -7);
-  else
-    return 0ULL;
-
-  bb::Bitboard mask = 0ULL;
-  for (int cur = ai + step; cur != bi; cur += step) mask |= bb::sq_bb(static_cast<Square>(cur));
-  return mask;
-}
-
-constexpr std::array<std::array<bb::Bitboard, 64>, 64> build_between_table() {
-  std::array<std::array<bb::Bitboard, 64>, 64> T{};
-  for (int a = 0; a < 64; ++a)
-    for (int b = 0; b < 64; ++b) T[a][b] = compute_between_single(a, b);
-  return T;
-}
-
-static inline constexpr auto Between = build_between_table();
-
 LILIA_ALWAYS_INLINE constexpr bb::Bitboard squares_between(Square a, Square b) noexcept {
-  return Between[(int)a][(int)b];
+  return bb::between(a, b);
 }
 
 // Align helpers
@@ -131,26 +97,56 @@ LILIA_ALWAYS_INLINE void compute_pins(const Board& b, Color us, const bb::Bitboa
 }
 
 // --------- Fast EP legality (tolerant on malformed setups) ---------
+// Zwei Figuren verlassen ihre Felder: Turmlinie auf der Reihe und (nur aus FEN möglich)
+// die Diagonale durch den geschlagenen Bauern.
 LILIA_ALWAYS_INLINE bool ep_is_legal_fast(const Board& b, Color side, Square from,
                                           Square to) noexcept {
   const bb::Bitboard kbb = b.getPieces(side, PT::King);
   if (!kbb) return true;
 
   const Square ksq = static_cast<Square>(bb::ctz64(kbb));
-  if (bb::rank_of(ksq) != bb::rank_of(from)) return true;
-
   const int to_i = (int)to;
   const int cap_i = (side == Color::White) ? (to_i - 8) : (to_i + 8);
   const Square capSq = static_cast<Square>(cap_i);
 
+  const bool sameRank = bb::rank_of(ksq) == bb::rank_of(from);
+  const bool diag = aligned_diag(ksq, capSq);
+  if (!sameRank && !diag) return true;
+
   bb::Bitboard occ = b.getAllPieces();
   occ &= ~bb::sq_bb(from);
   occ &= ~bb::sq_bb(capSq);
   occ |= bb::sq_bb(to);
 
-  const bb::Bitboard sliders = b.getPieces(~side, PT::Rook) | b.getPieces(~side, PT::Queen);
-  const bb::Bitboard rays = magic::sliding_attacks(magic::Slider::Rook, ksq, occ);
-  return (rays & sliders) == 0ULL;
+  const bb::Bitboard queens = b.getPieces(~side, PT::Queen);
+  if (sameRank) {
+    const bb::Bitboard sliders = b.getPieces(~side, PT::Rook) | queens;
+    if (magic::sliding_attacks(magic::Slider::Rook, ksq, occ) & sliders) return false;
+  }
+  if (diag) {
+    const bb::Bitboard sliders = b.getPieces(~side, PT::Bishop) | queens;
+    if (magic::sliding_attacks(magic::Slider::Bishop, ksq, occ) & sliders) return false;
+  }
+  return true;
+}
+
+// attackedBy() nach EP: der geschlagene Bauer auf capSq greift nicht mehr an (er kann der
+// Schachgeber sein), Slider sehen die Belegung nach dem Zug.
+LILIA_ALWAYS_INLINE bool attacked_after_ep(const Board& b, Square sq, Color by, bb::Bitboard occ,
+                                           Square capSq) noexcept {
+  const bb::Bitboard target = bb::sq_bb(sq);
+  const bb::Bitboard pawns = b.getPieces(by, PT::Pawn) & ~bb::sq_bb(capSq);
+  const bb::Bitboard pawnAtk = (by == Color::White) ? (bb::sw(target) | bb::se(target))
+                                                    : (bb::nw(target) | bb::ne(target));
+  if (pawnAtk & pawns) return true;
+  if (bb::knight_attacks_from(sq) & b.getPieces(by, PT::Knight)) return true;
+  const bb::Bitboard queens = b.getPieces(by, PT::Queen);
+  if (magic::sliding_attacks(magic::Slider::Bishop, sq, occ) &
+      (b.getPieces(by, PT::Bishop) | queens))
+    return true;
+  if (magic::sliding_attacks(magic::Slider::Rook, sq, occ) & (b.getPieces(by, PT::Rook) | queens))
+    return true;
+  return (bb::king_attacks_from(sq) & b.getPieces(by, PT::King)) != 0ULL;
 }
 
 // ---------------- Templated generators ----------------
@@ -584,7 +580,8 @@ LILIA_ALWAYS_INLINE void generateEvasions_T(const Board& b, const GameState& st,
   }
   const bb::Bitboard evasionTargets = checkers | blockMask;
 
-  // Masked generation for non-king moves (with pins applied inside gens)
+  // Masked generation for non-king moves (with pins applied inside gens);
+  // EP kommt nur aus dem strikten Block unten, sonst doppelt beim Blocken per EP
   const SideSets our = side_sets(b, us);
   const SideSets opp = side_sets(b, them);
 
@@ -592,14 +589,14 @@ LILIA_ALWAYS_INLINE void generateEvasions_T(const Board& b, const GameState& st,
     genPawnMoves_T<core::Color::White>(
         b, st, occ, our, opp, pins,
         [&](const Move& m) noexcept {
-          if (bb::sq_bb(m.to()) & evasionTargets) emit(m);
+          if (!m.isEnPassant() && (bb::sq_bb(m.to()) & evasionTargets)) emit(m);
         },
         evasionTargets);
   else
     genPawnMoves_T<core::Color::Black>(
         b, st, occ, our, opp, pins,
         [&](const Move& m) noexcept {
-          if (bb::sq_bb(m.to()) & evasionTargets) emit(m);
+          if (!m.isEnPassant() && (bb::sq_bb(m.to()) & evasionTargets)) emit(m);
         },
         evasionTargets);
 
@@ -641,7 +638,7 @@ LILIA_ALWAYS_INLINE void generateEvasions_T(const Board& b, const GameState& st,
         if (!(bb::sq_bb(epSq) & allowMask)) continue;
         const core::Square capSq = static_cast<core::Square>((int)epSq - 8);
         bb::Bitboard occAfter = (occ & ~bb::sq_bb(from) & ~bb::sq_bb(capSq)) | bb::sq_bb(epSq);
-        if (!attackedBy(b, ksq, them, occAfter))
+        if (!attacked_after_ep(b, ksq, them, occAfter, capSq))
           emit(Move{from, epSq, PT::None, true, true, CastleSide::None});
       }
     } else {
@@ -653,7 +650,7 @@ LILIA_ALWAYS_INLINE void generateEvasions_T(const Board& b, const GameState& st,
         if (!(bb::sq_bb(epSq) & allowMask)) continue;
         const core::Square capSq = static_cast<core::Square>((int)epSq + 8);
         bb::Bitboard occAfter = (occ & ~bb::sq_bb(from) & ~bb::sq_bb(capSq)) | bb::sq_bb(epSq);
-        if (!attackedBy(b, ksq, them, occAfter))
+        if (!attacked_after_ep(b, ksq, them, occAfter, capSq))
           emit(Move{from, epSq, PT::None, true, true, CastleSide::None});
       }
     }
@@ -670,6 +667,11 @@ struct AcceptCaptures {
     return m.isCapture() || m.promotion() != PT::None;
   }
 };
+struct AcceptQuiets {
+  LILIA_ALWAYS_INLINE bool operator()(const Move& m) const noexcept {
+    return !m.isCapture() && m.promotion() == PT::None;
+  }
+};
 
 template <class Emit, class Accept>
 LILIA_ALWAYS_INLINE void generate_all_regular(const Board& b, const GameState& st, Emit&& emit,
@@ -705,6 +707,25 @@ LILIA_ALWAYS_INLINE void generate_all_regular(const Board& b, const GameState& s
   genKingMoves_T(b, st, side, our, opp, occ, gated_emit);
 }
 
+// Legal: ohne Schach ist generate_all_regular schon exakt (Fesselungen, Königsfelder,
+// Rochade-Durchgang, EP-Aufdeckung); im Schach übernehmen die Evasions.
+template <class Emit, class Accept>
+LILIA_ALWAYS_INLINE void generate_legal(const Board& b, const GameState& st, Emit&& emit,
+                                        Accept&& accept) noexcept {
+  const Color side = st.sideToMove;
+  const bb::Bitboard occ = b.getAllPieces();
+  const bb::Bitboard kbb = b.getPieces(side, PT::King);
+  if (kbb && attackedBy(b, static_cast<Square>(bb::ctz64(kbb)), ~side, occ)) {
+    PinInfo pins;
+    compute_pins(b, side, occ, pins);
+    generateEvasions_T(b, st, &pins, [&](const Move& m) noexcept {
+      if (accept(m)) emit(m);
+    });
+    return;
+  }
+  generate_all_regular(b, st, emit, accept);
+}
+
 }  // namespace
 
 //-- -- -- -- -- -- -- --Public APIs-- -- -- -- -- -- -- --
@@ -836,6 +857,12 @@ int MoveGenerator::generateCapturesOnly(const Board& b, const GameState& st,
   generate_all_regular(b, st, sink, AcceptCaptures{});
   return buf.n;
 }
+int MoveGenerator::generateQuietsOnly(const Board& b, const GameState& st,
+                                      engine::MoveBuffer& buf) {
+  auto sink = [&](const Move& m) { buf.push_unchecked(m); };
+  generate_all_regular(b, st, sink, AcceptQuiets{});
+  return buf.n;
+}
 void MoveGenerator::generateEvasions(const Board& b, const GameState& st,
                                      std::vector<model::Move>& out) const {
   if (out.capacity() < 48) out.reserve(48);
@@ -860,4 +887,30 @@ int MoveGenerator::generateEvasions(const Board& b, const GameState& st, engine:
   return buf.n;
 }
 
+void MoveGenerator::generateLegalMoves(const Board& b, const GameState& st,
+                                       std::vector<model::Move>& out) const {
+  if (out.capacity() < 128) out.reserve(128);
+  out.clear();
+  auto sink = [&](const Move& m) { out.push_back(m); };
+  generate_legal(b, st, sink, AcceptAny{});
+}
+int MoveGenerator::generateLegalMoves(const Board& b, const GameState& st,
+                                      engine::MoveBuffer& buf) {
+  auto sink = [&](const Move& m) { buf.push_unchecked(m); };
+  generate_legal(b, st, sink, AcceptAny{});
+  return buf.n;
+}
+int MoveGenerator::generateLegalCaptures(const Board& b, const GameState& st,
+                                         engine::MoveBuffer& buf) {
+  auto sink = [&](const Move& m) { buf.push_unchecked(m); };
+  generate_legal(b, st, sink, AcceptCaptures{});
+  return buf.n;
+}
+int MoveGenerator::generateLegalQuiets(const Board& b, const GameState& st,
+                                       engine::MoveBuffer& buf) {
+  auto sink = [&](const Move& m) { buf.push_unchecked(m); };
+  generate_legal(b, st, sink, AcceptQuiets{});
+  return buf.n;
+}
+
 }  // namespace lilia::model
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdlib>
 #include <limits>
 
 #include "lilia/engine/config.hpp"
@@ -39,6 +40,38 @@ inline bool on_board_0_63(int s) {
 
 }  // namespace
 
+// Suchpfad (inkl. PV-Aufbau hinter der Wurzel) plus 100 Halbzüge Partie für Wiederholungen
+static_assert(STATE_STACK_SIZE >= engine::MAX_PLY + 100, "state stack too small for search");
+static_assert(NULL_STACK_SIZE >= engine::MAX_PLY, "null stack too small for search");
+
+Position::Position(const Position& o)
+    : m_board(o.m_board),
+      m_state(o.m_state),
+      m_hash(o.m_hash),
+      m_check(o.m_check),
+      evalAcc_(o.evalAcc_) {
+  m_history.copy_tail(o.m_history, o.m_state.halfmoveClock + 1);
+  m_null_history = o.m_null_history;
+  m_keys.copy_tail(o.m_keys, o.m_state.halfmoveClock + 1);
+  m_pliesFromNull = o.m_pliesFromNull;
+  m_repetition = o.m_repetition;
+}
+
+Position& Position::operator=(const Position& o) {
+  if (this == &o) return *this;
+  m_board = o.m_board;
+  m_state = o.m_state;
+  m_history.copy_tail(o.m_history, o.m_state.halfmoveClock + 1);
+  m_hash = o.m_hash;
+  m_check = o.m_check;
+  evalAcc_ = o.evalAcc_;
+  m_null_history = o.m_null_history;
+  m_keys.copy_tail(o.m_keys, o.m_state.halfmoveClock + 1);
+  m_pliesFromNull = o.m_pliesFromNull;
+  m_repetition = o.m_repetition;
+  return *this;
+}
+
 // ---------------------- Utility Checks ----------------------
 
 bool Position::checkInsufficientMaterial() {
@@ -84,23 +117,199 @@ bool Position::checkMoveRule() {
   return (m_state.halfmoveClock >= 100);
 }
 
-bool Position::checkRepetition() {
-  int count = 0;
-  const int n = (int)m_history.size();
-  const int lim = std::min<int>(n, m_state.halfmoveClock);
-  for (int back = 2; back <= lim; back += 2) {
-    const int idx = n - back;
-    if (idx < 0) break;
-    if (m_history[idx].zobristKey == m_hash && ++count >= 2) return true;
+// Nach einem Zug: Key der Vorstellung ablegen und die neue Stellung gegen den Ring prüfen.
+// Gleiche Stellungen liegen eine gerade Anzahl Halbzüge zurück und nie hinter einem
+// irreversiblen Zug oder Nullzug; die nächste genügt, sie kennt ihre eigenen Vorgänger.
+void Position::pushRepetitionKey() {
+  m_keys.push(RepEntry{m_history.back().zobristKey, m_repetition});
+  ++m_pliesFromNull;
+  m_repetition = 0;
+  const int end = std::min({int(m_state.halfmoveClock), int(m_pliesFromNull), m_keys.size()});
+  for (int back = 4; back <= end; back += 2) {
+    const RepEntry& e = m_keys.from_top(back - 1);
+    if (e.key == m_hash) {
+      m_repetition = std::int16_t(e.repetition ? -back : back);
+      break;
+    }
+  }
+}
+
+bool Position::upcomingRepetition(int ply) const noexcept {
+  const int end = std::min({int(m_state.halfmoveClock), int(m_pliesFromNull), m_keys.size()});
+  if (end < 3) return false;
+
+  const bb::Bitboard originalKey = m_hash;
+  // other == 0: die Züge des Gegners seit Stellung i heben sich auf
+  bb::Bitboard other = originalKey ^ m_keys.from_top(0).key ^ Zobrist::side;
+  for (int i = 3; i <= end; i += 2) {
+    other ^= m_keys.from_top(i - 2).key ^ m_keys.from_top(i - 1).key ^ Zobrist::side;
+    if (other) continue;
+
+    const RepEntry& e = m_keys.from_top(i - 1);
+    const bb::Bitboard moveKey = originalKey ^ e.key;
+    int j = detail::cuckoo_h1(moveKey);
+    if (CUCKOO.key[j] != moveKey) {
+      j = detail::cuckoo_h2(moveKey);
+      if (CUCKOO.key[j] != moveKey) continue;
+    }
+    const auto s1 = static_cast<core::Square>(CUCKOO.from[j]);
+    const auto s2 = static_cast<core::Square>(CUCKOO.to[j]);
+    if (bb::between(s1, s2) & m_board.getAllPieces()) continue;
+
+    if (ply > i || e.repetition) return true;
   }
   return false;
 }
 
-bool Position::inCheck() const {
-  const bb::Bitboard kbb = m_board.getPieces(m_state.sideToMove, core::PieceType::King);
-  if (!kbb) return false;
-  const core::Square ksq = static_cast<core::Square>(bb::ctz64(kbb));
-  return attackedBy(m_board, ksq, ~m_state.sideToMove, m_board.getAllPieces());
+void Position::buildCheckInfo() {
+  using PT = core::PieceType;
+  const bb::Bitboard occ = m_board.getAllPieces();
+  CheckInfo& ci = m_check;
+
+  // Fesselungen / Abzugsfiguren für beide Könige
+  for (core::Color c : {core::Color::White, core::Color::Black}) {
+    const int i = bb::ci(c);
+    ci.blockers[i] = ci.pinners[i] = 0;
+    const bb::Bitboard kbb = m_board.getPieces(c, PT::King);
+    if (!kbb) continue;
+    const core::Square ksq = static_cast<core::Square>(bb::ctz64(kbb));
+    const bb::Bitboard queens = m_board.getPieces(~c, PT::Queen);
+    const bb::Bitboard snipers =
+        (magic::sliding_attacks(magic::Slider::Rook, ksq, 0) &
+         (m_board.getPieces(~c, PT::Rook) | queens)) |
+        (magic::sliding_attacks(magic::Slider::Bishop, ksq, 0) &
+         (m_board.getPieces(~c, PT::Bishop) | queens));
+    const bb::Bitboard occNoSnipers = occ ^ snipers;
+    for (bb::Bitboard s = snipers; s;) {
+      const core::Square sniper = bb::pop_lsb(s);
+      const bb::Bitboard b = bb::between(ksq, sniper) & occNoSnipers;
+      if (b && !(b & (b - 1))) {
+        ci.blockers[i] |= b;
+        if (b & m_board.getPieces(c)) ci.pinners[i] |= bb::sq_bb(sniper);
+      }
+    }
+  }
+
+  buildCheckers();
+}
+
+// Nur der Teil, der von der Seite am Zug abhängt (reicht nach einem Nullzug)
+void Position::buildCheckers() {
+  using PT = core::PieceType;
+  const bb::Bitboard occ = m_board.getAllPieces();
+  CheckInfo& ci = m_check;
+  const core::Color us = m_state.sideToMove, them = ~us;
+
+  ci.checkers = 0;
+  if (const bb::Bitboard kUs = m_board.getPieces(us, PT::King)) {
+    const core::Square ksq = static_cast<core::Square>(bb::ctz64(kUs));
+    const bb::Bitboard queens = m_board.getPieces(them, PT::Queen);
+    ci.checkers =
+        pawn_attackers_to(ksq, them, m_board.getPieces(them, PT::Pawn)) |
+        (bb::knight_attacks_from(ksq) & m_board.getPieces(them, PT::Knight)) |
+        (magic::sliding_attacks(magic::Slider::Bishop, ksq, occ) &
+         (m_board.getPieces(them, PT::Bishop) | queens)) |
+        (magic::sliding_attacks(magic::Slider::Rook, ksq, occ) &
+         (m_board.getPieces(them, PT::Rook) | queens));
+  }
+
+  for (auto& sq : ci.checkSquares) sq = 0;
+  if (const bb::Bitboard kThem = m_board.getPieces(them, PT::King)) {
+    const core::Square ksq = static_cast<core::Square>(bb::ctz64(kThem));
+    const bb::Bitboard k = bb::sq_bb(ksq);
+    ci.checkSquares[(int)PT::Pawn] = us == core::Color::White ? (bb::sw(k) | bb::se(k))
+                                                              : (bb::nw(k) | bb::ne(k));
+    ci.checkSquares[(int)PT::Knight] = bb::knight_attacks_from(ksq);
+    ci.checkSquares[(int)PT::Bishop] = magic::sliding_attacks(magic::Slider::Bishop, ksq, occ);
+    ci.checkSquares[(int)PT::Rook] = magic::sliding_attacks(magic::Slider::Rook, ksq, occ);
+    ci.checkSquares[(int)PT::Queen] =
+        ci.checkSquares[(int)PT::Bishop] | ci.checkSquares[(int)PT::Rook];
+  }
+}
+
+bool Position::givesCheck(const Move& m) const {
+  using PT = core::PieceType;
+  const auto mover = m_board.getPiece(m.from());
+  if (!mover) return false;
+  const core::Color us = m_state.sideToMove, them = ~us;
+  const bb::Bitboard kThem = m_board.getPieces(them, PT::King);
+  if (!kThem) return false;
+  const core::Square ksq = static_cast<core::Square>(bb::ctz64(kThem));
+  const bb::Bitboard fromBB = bb::sq_bb(m.from()), toBB = bb::sq_bb(m.to());
+
+  // Direktes Schach
+  if (m.promotion() == PT::None && (m_check.checkSquares[(int)mover->type] & toBB)) return true;
+
+  // Abzugsschach: Blocker verlässt die Linie zum König
+  if ((m_check.blockers[bb::ci(them)] & fromBB) && !bb::aligned(m.from(), m.to(), ksq))
+    return true;
+
+  const bb::Bitboard occ = m_board.getAllPieces();
+  if (m.promotion() != PT::None) {
+    const bb::Bitboard occAfter = occ ^ fromBB;
+    switch (m.promotion()) {
+      case PT::Knight:
+        return (bb::knight_attacks_from(m.to()) & kThem) != 0;
+      case PT::Bishop:
+        return (magic::sliding_attacks(magic::Slider::Bishop, m.to(), occAfter) & kThem) != 0;
+      case PT::Rook:
+        return (magic::sliding_attacks(magic::Slider::Rook, m.to(), occAfter) & kThem) != 0;
+      case PT::Queen:
+        return ((magic::sliding_attacks(magic::Slider::Bishop, m.to(), occAfter) |
+                 magic::sliding_attacks(magic::Slider::Rook, m.to(), occAfter)) &
+                kThem) != 0;
+      default:
+        return false;
+    }
+  }
+
+  // EP: geschlagener Bauer kann eine Linie öffnen
+  if (m.isEnPassant()) {
+    const core::Square capSq = static_cast<core::Square>(us == core::Color::White ? m.to() - 8
+                                                                                 : m.to() + 8);
+    const bb::Bitboard occAfter = (occ ^ fromBB ^ bb::sq_bb(capSq)) | toBB;
+    const bb::Bitboard queens = m_board.getPieces(us, PT::Queen);
+    return (magic::sliding_attacks(magic::Slider::Rook, ksq, occAfter) &
+            (m_board.getPieces(us, PT::Rook) | queens)) ||
+           (magic::sliding_attacks(magic::Slider::Bishop, ksq, occAfter) &
+            (m_board.getPieces(us, PT::Bishop) | queens));
+  }
+
+  // Rochade: der Turm landet auf f- bzw. d-Linie
+  if (m.castle() != CastleSide::None) {
+    const bool king = m.castle() == CastleSide::KingSide;
+    const int rank = us == core::Color::White ? 0 : 56;
+    const core::Square rookTo = static_cast<core::Square>(rank + (king ? 5 : 3));
+    const core::Square rookFrom = static_cast<core::Square>(rank + (king ? 7 : 0));
+    const bb::Bitboard occAfter = (occ ^ fromBB ^ bb::sq_bb(rookFrom)) | toBB | bb::sq_bb(rookTo);
+    return (magic::sliding_attacks(magic::Slider::Rook, rookTo, occAfter) & kThem) != 0;
+  }
+  return false;
+}
+
+std::optional<Move> Position::resolveMove(const Move& m) const {
+  const core::Square from = m.from(), to = m.to();
+  const auto piece = m_board.getPiece(from);
+  if (!piece || piece->color != m_state.sideToMove) return std::nullopt;
+
+  const bool pawn = piece->type == core::PieceType::Pawn;
+  const int toRank = bb::rank_of(to);
+  if (pawn ? ((toRank == 0 || toRank == 7) != (m.promotion() != core::PieceType::None))
+           : m.promotion() != core::PieceType::None)
+    return std::nullopt;
+
+  // Flags so setzen, wie sie der Generator setzt
+  const auto target = m_board.getPiece(to);
+  const bool ep =
+      pawn && to == m_state.enPassantSquare && !target && bb::file_of(from) != bb::file_of(to);
+  const bool cap = ep || (target && target->color != piece->color);
+  CastleSide cs = CastleSide::None;
+  if (piece->type == core::PieceType::King && (to == from + 2 || to + 2 == from))
+    cs = to > from ? CastleSide::KingSide : CastleSide::QueenSide;
+
+  const Move full(from, to, m.promotion(), cap, ep, cs);
+  if (!isPseudoLegal(full)) return std::nullopt;
+  return full;
 }
 
 // ---------------------- isPseudoLegal (for search) ----------------------
@@ -236,208 +445,276 @@ bool Position::isPseudoLegal(const Move& m) const {
   }
   return false;
 }
-// ------- SEE (Static Exchange Evaluation), Stockfish-style swap -------
-// Returns true if material result of playing 'm' on square 'to' is >= 0.
-bool Position::see(const model::Move& m) const {
-  using core::Color;
-  using core::PieceType;
-  using core::Square;
-
-  // Trivial non-captures: SEE is used for captures; be permissive for quiets.
-  if (!m.isCapture() && !m.isEnPassant()) return true;
-
-  const auto fromP = m_board.getPiece(m.from());
-  if (!fromP) return true;
 
-  const Color us = fromP->color;
-  const Color them = Color(~us);
-  const Square to = m.to();
+// ---------------------- SEE ----------------------
 
-  // Snapshot occupancy and piece sets
-  bb::Bitboard occ = m_board.getAllPieces();
-
-  bb::Bitboard pcs[2][6];
-  for (int c = 0; c < 2; ++c)
-    for (int pt = 0; pt < 6; ++pt) pcs[c][pt] = m_board.getPieces((Color)c, (PieceType)pt);
+namespace {
 
-  auto alive = [&](Color c, PieceType pt) -> bb::Bitboard { return pcs[(int)c][(int)pt] & occ; };
-  auto val = [&](PieceType pt) -> int { return engine::base_value[(int)pt]; };
+// Figurenmengen für den Abtausch, einmal je Stellung
+struct SeeBoards {
+  bb::Bitboard byType[6];     // beide Farben
+  bb::Bitboard byColor[2];
+  bb::Bitboard diag, ortho;   // L|D bzw. T|D beider Farben
+};
 
-  auto king_sq = [&](Color c) -> Square {
-    bb::Bitboard kbb = pcs[(int)c][(int)PieceType::King];
-    return (Square)bb::ctz64(kbb);
-  };
+SeeBoards see_boards(const Board& b) {
+  using PT = core::PieceType;
+  SeeBoards sb{};
+  for (int pt = 0; pt < 6; ++pt)
+    sb.byType[pt] = b.getPieces(core::Color::White, (PT)pt) | b.getPieces(core::Color::Black, (PT)pt);
+  sb.byColor[0] = b.getPieces(core::Color::White);
+  sb.byColor[1] = b.getPieces(core::Color::Black);
+  sb.diag = sb.byType[(int)PT::Bishop] | sb.byType[(int)PT::Queen];
+  sb.ortho = sb.byType[(int)PT::Rook] | sb.byType[(int)PT::Queen];
+  return sb;
+}
 
-  // Helpers to get all attackers of side 'c' to 'to' given current 'occ'
-  auto diag_rays = [&](bb::Bitboard o) {
-    return magic::sliding_attacks(magic::Slider::Bishop, to, o);
-  };
-  auto ortho_rays = [&](bb::Bitboard o) {
-    return magic::sliding_attacks(magic::Slider::Rook, to, o);
-  };
+// Alle Angreifer beider Farben auf sq bei Belegung occ
+bb::Bitboard see_attackers_to(const SeeBoards& sb, core::Square sq, bb::Bitboard occ) {
+  using PT = core::PieceType;
+  const bb::Bitboard pawns = sb.byType[(int)PT::Pawn];
+  return pawn_attackers_to(sq, core::Color::White, pawns & sb.byColor[0]) |
+         pawn_attackers_to(sq, core::Color::Black, pawns & sb.byColor[1]) |
+         (bb::knight_attacks_from(sq) & sb.byType[(int)PT::Knight]) |
+         (bb::king_attacks_from(sq) & sb.byType[(int)PT::King]) |
+         (magic::sliding_attacks(magic::Slider::Bishop, sq, occ) & sb.diag) |
+         (magic::sliding_attacks(magic::Slider::Rook, sq, occ) & sb.ortho);
+}
 
-  auto pawn_atk = [&](Color c) { return pawn_attackers_to(to, c, alive(c, PieceType::Pawn)); };
-  auto knight_atk = [&](Color c) {
-    return bb::knight_attacks_from(to) & alive(c, PieceType::Knight);
-  };
-  auto bishop_atk = [&](Color c, bb::Bitboard o) {
-    return diag_rays(o) & alive(c, PieceType::Bishop);
-  };
-  auto rook_atk = [&](Color c, bb::Bitboard o) {
-    return ortho_rays(o) & alive(c, PieceType::Rook);
-  };
-  auto queen_atk = [&](Color c, bb::Bitboard o) {
-    const bb::Bitboard rays = diag_rays(o) | ortho_rays(o);
-    return rays & alive(c, PieceType::Queen);
-  };
+inline int see_value(core::PieceType pt) {
+  return engine::base_value[(int)pt];
+}
 
-  // Pin/legal guard: only check when we actually consider that specific attacker
-  auto illegal_due_to_pin = [&](Color c, Square fromSq, bb::Bitboard oNow) -> bool {
-    // Move piece from 'fromSq' to 'to' and see if own king becomes attacked.
-    bb::Bitboard kbb = pcs[(int)c][(int)PieceType::King] & oNow;
-    if (!kbb) return false;
-    const Square ksq = (Square)bb::ctz64(kbb);
+}  // namespace
 
-    // Remove from, add on 'to' (square 'to' remains occupied after a capture)
-    bb::Bitboard occTest = (oNow & ~bb::sq_bb(fromSq)) | bb::sq_bb(to);
-    return attackedBy(m_board, ksq, Color(~c), occTest);
-  };
+// Der Zug selbst: was er schlägt (inkl. Umwandlungsgewinn), welche Figur danach auf 'to' steht
+// und die Belegung nach dem Zug ohne 'to'. false = Rochade, SEE ist dann 0.
+bool Position::see_start(const Move& m, int& gain, core::PieceType& onTo,
+                         bb::Bitboard& occ) const {
+  const auto mover = m_board.getPiece(m.from());
+  if (!mover || m.castle() != CastleSide::None) return false;
+  if (mover->type == core::PieceType::King &&
+      std::abs((int)m.to() - (int)m.from()) == 2)  // Rochade ohne Flag
+    return false;
 
-  // Pick the least valuable legal attacker for side 'c'. Returns false if none.
-  auto pick_lva = [&](Color c, Square& fromSq, PieceType& pt, bb::Bitboard oNow) -> bool {
-    // Compute rays once for current occupancy
-    const bb::Bitboard diag = diag_rays(oNow);
-    const bb::Bitboard ortho = ortho_rays(oNow);
-
-    // Order: Pawn, Knight, Bishop, Rook, Queen, King
-    bb::Bitboard cand;
-
-    // Pawns
-    cand = pawn_atk(c) & alive(c, PieceType::Pawn);
-    while (cand) {
-      Square f = bb::pop_lsb(cand);
-      if (!illegal_due_to_pin(c, f, oNow)) {
-        fromSq = f;
-        pt = PieceType::Pawn;
-        return true;
-      }
-    }
+  const core::Square to = m.to();
+  occ = m_board.getAllPieces() & ~bb::sq_bb(m.from()) & ~bb::sq_bb(to);
+  gain = 0;
+  if (m.isEnPassant()) {
+    gain = see_value(core::PieceType::Pawn);
+    occ &= ~bb::sq_bb(mover->color == core::Color::White ? core::Square(to - 8)
+                                                         : core::Square(to + 8));
+  } else if (auto cap = m_board.getPiece(to)) {
+    gain = see_value(cap->type);
+  }
+  onTo = mover->type;
+  if (m.promotion() != core::PieceType::None) {
+    gain += see_value(m.promotion()) - see_value(core::PieceType::Pawn);
+    onTo = m.promotion();
+  }
+  return true;
+}
 
-    // Knights
-    cand = knight_atk(c) & alive(c, PieceType::Knight);
-    while (cand) {
-      Square f = bb::pop_lsb(cand);
-      if (!illegal_due_to_pin(c, f, oNow)) {
-        fromSq = f;
-        pt = PieceType::Knight;
-        return true;
-      }
-    }
+// Schwellen-SEE (Swap mit X-Rays): Ist der Materialsaldo des Abtauschs auf m.to() >= threshold?
+// Beide Seiten dürfen jederzeit aufhören; gefesselte Figuren schlagen nicht, solange ihr Fessler
+// steht. Ruhige Züge riskieren nur die ziehende Figur.
+bool Position::see_ge(const Move& m, int threshold) const {
+  using PT = core::PieceType;
+  int gain;
+  PT onTo;
+  bb::Bitboard occ;
+  if (!see_start(m, gain, onTo, occ)) return 0 >= threshold;
+
+  int swap = gain - threshold;
+  if (swap < 0) return false;  // selbst ohne Rückschlag zu wenig
+  swap = see_value(onTo) - swap;
+  if (swap <= 0) return true;  // selbst der Verlust der Figur hält die Schwelle
+
+  const SeeBoards sb = see_boards(m_board);
+  const core::Square to = m.to();
+  bb::Bitboard attackers = see_attackers_to(sb, to, occ);
+  core::Color stm = m_state.sideToMove;
+  int res = 1;
 
-    // Bishops
-    cand = (diag & alive(c, PieceType::Bishop));
-    while (cand) {
-      Square f = bb::pop_lsb(cand);
-      if (!illegal_due_to_pin(c, f, oNow)) {
-        fromSq = f;
-        pt = PieceType::Bishop;
-        return true;
-      }
+  for (;;) {
+    stm = ~stm;
+    attackers &= occ;
+    bb::Bitboard stmAttackers = attackers & sb.byColor[bb::ci(stm)];
+    if (!stmAttackers) break;
+    // gefesselte Verteidiger bleiben stehen, solange ihr Fessler noch steht
+    if (m_check.pinners[bb::ci(stm)] & occ) {
+      stmAttackers &= ~m_check.blockers[bb::ci(stm)];
+      if (!stmAttackers) break;
     }
+    res ^= 1;
+
+    // billigster Schläger; danach durch ihn verdeckte Slider nachladen
+    int pt = 0;
+    while (pt < 5 && !(stmAttackers & sb.byType[pt])) ++pt;
+    if (pt == (int)PT::King)  // König schlägt nur, wenn nichts mehr zurückschlägt
+      return (attackers & sb.byColor[bb::ci(~stm)]) ? res ^ 1 : res;
+
+    if ((swap = see_value((PT)pt) - swap) < res) break;
+    occ ^= bb::sq_bb(static_cast<core::Square>(bb::ctz64(stmAttackers & sb.byType[pt])));
+    if (pt == (int)PT::Pawn || pt == (int)PT::Bishop || pt == (int)PT::Queen)
+      attackers |= magic::sliding_attacks(magic::Slider::Bishop, to, occ) & sb.diag;
+    if (pt == (int)PT::Rook || pt == (int)PT::Queen)
+      attackers |= magic::sliding_attacks(magic::Slider::Rook, to, occ) & sb.ortho;
+  }
+  return res != 0;
+}
 
-    // Rooks
-    cand = (ortho & alive(c, PieceType::Rook));
-    while (cand) {
-      Square f = bb::pop_lsb(cand);
-      if (!illegal_due_to_pin(c, f, oNow)) {
-        fromSq = f;
-        pt = PieceType::Rook;
-        return true;
-      }
+// Exakter SEE-Wert für n Züge. Angreifer je Zielfeld werden einmal berechnet und für alle
+// Schläge auf dasselbe Feld geteilt; den ziehenden Stein und seine X-Rays korrigiert jeder Zug.
+void Position::see_values(const Move* moves, int n, int* out) const {
+  using PT = core::PieceType;
+  const SeeBoards sb = see_boards(m_board);
+  const bb::Bitboard occAll = m_board.getAllPieces();
+  const core::Color us = m_state.sideToMove;
+
+  bb::Bitboard cachedTo = 0;  // Felder mit gültigem Eintrag in baseAtt
+  bb::Bitboard baseAtt[64];
+
+  for (int k = 0; k < n; ++k) {
+    const Move& m = moves[k];
+    int gain0;
+    PT onTo;
+    bb::Bitboard occ;
+    if (!see_start(m, gain0, onTo, occ)) {
+      out[k] = 0;
+      continue;
     }
-
-    // Queens
-    cand = ((diag | ortho) & alive(c, PieceType::Queen));
-    while (cand) {
-      Square f = bb::pop_lsb(cand);
-      if (!illegal_due_to_pin(c, f, oNow)) {
-        fromSq = f;
-        pt = PieceType::Queen;
-        return true;
-      }
+    const core::Square to = m.to(), from = m.from();
+    if (!(cachedTo & bb::sq_bb(to))) {
+      baseAtt[to] = see_attackers_to(sb, to, occAll);
+      cachedTo |= bb::sq_bb(to);
     }
-
-    // King (check target not covered after king moves there)
-    bb::Bitboard kbb = alive(c, PieceType::King);
-    if (kbb) {
-      const Square kf = (Square)bb::ctz64(kbb);
-      if (bb::king_attacks_from(kf) & bb::sq_bb(to)) {
-        bb::Bitboard occK = (oNow & ~bb::sq_bb(kf)) | bb::sq_bb(to);
-        if (!attackedBy(m_board, to, Color(~c), occK)) {
-          fromSq = kf;
-          pt = PieceType::King;
-          return true;
-        }
-      }
+    bb::Bitboard attackers = baseAtt[to];
+    // hinter from (oder dem EP-Bauern) frei gewordene Linien
+    if (bb::line(from, to) || m.isEnPassant())
+      attackers |= (magic::sliding_attacks(magic::Slider::Bishop, to, occ) & sb.diag) |
+                   (magic::sliding_attacks(magic::Slider::Rook, to, occ) & sb.ortho);
+
+    int gain[32];
+    int d = 0;
+    gain[0] = gain0;
+    int onToVal = see_value(onTo);
+    core::Color stm = us;
+    for (;;) {
+      stm = ~stm;
+      attackers &= occ;
+      bb::Bitboard stmAttackers = attackers & sb.byColor[bb::ci(stm)];
+      if (m_check.pinners[bb::ci(stm)] & occ) stmAttackers &= ~m_check.blockers[bb::ci(stm)];
+      if (!stmAttackers) break;
+
+      int pt = 0;
+      while (pt < 5 && !(stmAttackers & sb.byType[pt])) ++pt;
+      if (pt == (int)PT::King && (attackers & sb.byColor[bb::ci(~stm)])) break;
+
+      ++d;
+      gain[d] = onToVal - gain[d - 1];
+      if (d == 31) break;
+
+      onToVal = see_value((PT)pt);
+      occ ^= bb::sq_bb(static_cast<core::Square>(bb::ctz64(stmAttackers & sb.byType[pt])));
+      if (pt == (int)PT::Pawn || pt == (int)PT::Bishop || pt == (int)PT::Queen)
+        attackers |= magic::sliding_attacks(magic::Slider::Bishop, to, occ) & sb.diag;
+      if (pt == (int)PT::Rook || pt == (int)PT::Queen)
+        attackers |= magic::sliding_attacks(magic::Slider::Rook, to, occ) & sb.ortho;
     }
-    return false;
-  };
-
-  // Identify captured piece and adjust occupancy for initial position at the node
-  PieceType captured = PieceType::None;
-  if (m.isEnPassant()) {
-    captured = PieceType::Pawn;
-    const Square capSq = (us == Color::White) ? Square(int(to) - 8) : Square(int(to) + 8);
-    occ &= ~bb::sq_bb(capSq);  // remove the pawn that will be taken EP
-  } else if (auto cap = m_board.getPiece(to)) {
-    captured = cap->type;
-    occ &= ~bb::sq_bb(to);  // square 'to' becomes temporarily empty before we land on it
+    // jede Seite darf statt zu schlagen aufhören
+    for (; d > 0; --d) gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    out[k] = gain[0];
   }
+}
 
-  // Move our piece to 'to' (occupancy stays with 'to' occupied from this point on)
-  occ &= ~bb::sq_bb(m.from());
-  PieceType pieceOnTo = (m.promotion() != PieceType::None) ? m.promotion() : fromP->type;
-  occ |= bb::sq_bb(to);
+bool Position::see(const model::Move& m) const {
+  if (!m.isCapture() && !m.isEnPassant()) return true;
+  return see_ge(m, 0);
+}
 
-  // Swap list
-  int gain[32];
-  int d = 0;
-  gain[d++] = val(captured);
+// ================== Make/Unmake (fast paths kept) ==================
 
-  // Alternate sides starting with the opponent
-  Color side = them;
+// Spiegelt die Hash-Updates von applyMove(), nur ohne Brett/State anzufassen.
+Position::ChildKeys Position::key_after(const Move& m) const noexcept {
+  const core::Color us = m_state.sideToMove;
+  const core::Color them = ~us;
+  std::uint64_t key = m_hash;
+  std::uint64_t pawnKey = m_state.pawnKey;
 
-  // Iteratively “exchange” on 'to'
-  for (;;) {
-    Square from2 = core::NO_SQUARE;
-    PieceType pt2 = PieceType::None;
+  auto xorPiece = [&](core::Color c, core::PieceType pt, core::Square s) {
+    const std::uint64_t z = Zobrist::piece[bb::ci(c)][static_cast<int>(pt)][s];
+    key ^= z;
+    if (pt == core::PieceType::Pawn) pawnKey ^= z;
+  };
 
-    if (!pick_lva(side, from2, pt2, occ)) break;
+  const auto fromPiece = m_board.getPiece(m.from());
+  if (!fromPiece) return {key, pawnKey};
+  const core::PieceType pt = fromPiece->type;
+  const core::Square prevEP = m_state.enPassantSquare;
 
-    // They take what's on 'to'
-    gain[d] = val(pieceOnTo) - gain[d - 1];
-    ++d;
+  key ^= epHashFor(prevEP, us);
 
-    // Prune: if this side is failing already, no need to go deeper
-    if (gain[d - 1] < 0) break;
+  bool isCastle = m.castle() != CastleSide::None;
+  if (!isCastle && pt == core::PieceType::King) {
+    isCastle = (us == core::Color::White && m.from() == bb::E1 &&
+                (m.to() == core::Square{6} || m.to() == core::Square{2})) ||
+               (us == core::Color::Black && m.from() == bb::E8 &&
+                (m.to() == core::Square{62} || m.to() == core::Square{58}));
+  }
 
-    // Move attacker onto 'to' (remove it from its square; 'to' stays occupied)
-    occ &= ~bb::sq_bb(from2);
+  bool isEP = m.isEnPassant();
+  if (!isEP && pt == core::PieceType::Pawn && prevEP != core::NO_SQUARE && m.to() == prevEP) {
+    const int df = (int)m.to() - (int)m.from();
+    isEP = (df == 7 || df == 9 || df == -7 || df == -9) && !m_board.getPiece(m.to()).has_value();
+  }
 
-    // New piece now sits on 'to'
-    pieceOnTo = pt2;
-    side = Color(~side);
+  if (isEP) {
+    xorPiece(them, core::PieceType::Pawn,
+             static_cast<core::Square>(us == core::Color::White ? m.to() - 8 : m.to() + 8));
+  } else if (auto cap = m_board.getPiece(m.to()); cap && cap->color == them) {
+    xorPiece(them, cap->type, m.to());
+  }
 
-    if (d >= 31) break;  // sanity guard
+  xorPiece(us, pt, m.from());
+  xorPiece(us, m.promotion() != core::PieceType::None ? m.promotion() : pt, m.to());
+
+  if (isCastle) {
+    const bool kingSide = (m.to() == core::Square{6} || m.to() == core::Square{62} ||
+                           m.castle() == CastleSide::KingSide);
+    const core::Square rFrom = us == core::Color::White ? (kingSide ? bb::H1 : bb::A1)
+                                                        : (kingSide ? bb::H8 : bb::A8);
+    const core::Square rTo = static_cast<core::Square>(kingSide ? rFrom - 2 : rFrom + 3);
+    xorPiece(us, core::PieceType::Rook, rFrom);
+    xorPiece(us, core::PieceType::Rook, rTo);
   }
 
-  // Negamax backpropagation
-  while (--d) gain[d - 1] = std::max(-gain[d], gain[d - 1]);
+  const std::uint8_t prevCR = m_state.castlingRights;
+  const std::uint8_t newCR =
+      prevCR & ~(CR_CLEAR_FROM[(int)m.from()] | CR_CLEAR_TO[(int)m.to()]);
+  if (prevCR != newCR) key ^= Zobrist::castling[prevCR & 0xF] ^ Zobrist::castling[newCR & 0xF];
+
+  key ^= Zobrist::side;
 
-  return gain[0] >= 0;
+  // neues EP-Feld nur nach Doppelschritt; die Bauern des Gegners bleiben dabei unverändert
+  if (pt == core::PieceType::Pawn && ((int)m.to() - (int)m.from() == 16 ||
+                                      (int)m.from() - (int)m.to() == 16)) {
+    key ^= epHashFor(static_cast<core::Square>(((int)m.from() + (int)m.to()) / 2), them);
+  }
+  return {key, pawnKey};
 }
 
-// ================== Make/Unmake (fast paths kept) ==================
+StateInfo Position::saveState(const Move& m) const {
+  StateInfo st{};
+  st.move = m;
+  st.zobristKey = m_hash;
+  st.prevCastlingRights = m_state.castlingRights;
+  st.prevEnPassantSquare = m_state.enPassantSquare;
+  st.prevHalfmoveClock = m_state.halfmoveClock;
+  st.prevPawnKey = m_state.pawnKey;
+  st.prevCheck = m_check;
+  return st;
+}
 
 bool Position::doMove(const Move& m) {
   if (m.from() == m.to()) return false;
@@ -463,14 +740,7 @@ bool Position::doMove(const Move& m) {
     }
   }
 
-  StateInfo st{};
-  st.move = m;
-  st.zobristKey = m_hash;
-  st.prevCastlingRights = m_state.castlingRights;
-  st.prevEnPassantSquare = m_state.enPassantSquare;
-  st.prevHalfmoveClock = m_state.halfmoveClock;
-  st.prevPawnKey = m_state.pawnKey;
-
+  StateInfo st = saveState(m);
   applyMove(m, st);
 
   // Illegale Züge (eigener König im Schach oder castle-through-check via generator-guard)
@@ -490,17 +760,33 @@ bool Position::doMove(const Move& m) {
     return false;
   }
 
-  m_history.push_back(st);
+  buildCheckInfo();
+  st.gaveCheck = m_check.checkers != 0;
+  m_history.push(st);
+  pushRepetitionKey();
   return true;
 }
 
+void Position::doMoveLegal(const Move& m) {
+  StateInfo st = saveState(m);
+  applyMove(m, st);
+  buildCheckInfo();
+  st.gaveCheck = m_check.checkers != 0;
+  m_history.push(st);
+  pushRepetitionKey();
+}
+
 void Position::undoMove() {
   if (m_history.empty()) return;
-  StateInfo st = m_history.back();
+  const StateInfo& st = m_history.back();
   unapplyMove(st);
   m_hash = st.zobristKey;
   m_state.pawnKey = st.prevPawnKey;
-  m_history.pop_back();
+  m_check = st.prevCheck;
+  m_history.pop();
+  m_repetition = m_keys.back().repetition;
+  m_keys.pop();
+  --m_pliesFromNull;
 }
 
 bool Position::doNullMove() {
@@ -510,6 +796,9 @@ bool Position::doNullMove() {
   st.prevEnPassantSquare = m_state.enPassantSquare;
   st.prevHalfmoveClock = m_state.halfmoveClock;
   st.prevFullmoveNumber = m_state.fullmoveNumber;
+  st.prevCheck = m_check;
+  st.prevPliesFromNull = m_pliesFromNull;
+  st.prevRepetition = m_repetition;
 
   xorEPRelevant();
   m_state.enPassantSquare = core::NO_SQUARE;
@@ -520,14 +809,17 @@ bool Position::doNullMove() {
   m_state.sideToMove = ~m_state.sideToMove;
   if (m_state.sideToMove == core::Color::White) ++m_state.fullmoveNumber;
 
-  m_null_history.push_back(st);
+  buildCheckers();
+  m_null_history.push(st);
+  m_pliesFromNull = 0;
+  m_repetition = 0;
   return true;
 }
 
 void Position::undoNullMove() {
   if (m_null_history.empty()) return;
-  NullState st = m_null_history.back();
-  m_null_history.pop_back();
+  const NullState st = m_null_history.back();
+  m_null_history.pop();
 
   m_state.sideToMove = ~m_state.sideToMove;
   hashXorSide();
@@ -540,6 +832,9 @@ void Position::undoNullMove() {
   m_state.halfmoveClock = st.prevHalfmoveClock;
 
   m_hash = st.zobristKey;
+  m_check = st.prevCheck;
+  m_pliesFromNull = st.prevPliesFromNull;
+  m_repetition = st.prevRepetition;
 }
 
 // ===== Position::applyMove (optimized) =====
@@ -688,15 +983,6 @@ void Position::applyMove(const Move& m, StateInfo& st) {
     }
   }
 
-  // gaveCheck (compute before side flip)
-  const bb::Bitboard kThem = m_board.getPieces(them, core::PieceType::King);
-  std::uint8_t gc = 0;
-  if (kThem) {
-    const core::Square ksqThem = static_cast<core::Square>(bb::ctz64(kThem));
-    if (attackedBy(m_board, ksqThem, us, m_board.getAllPieces())) gc = 1;
-  }
-  st.gaveCheck = gc;
-
   // 50-move rule
   if (placed.type == core::PieceType::Pawn || st.captured.type != core::PieceType::None)
     m_state.halfmoveClock = 0;
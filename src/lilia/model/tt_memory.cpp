@@ -0,0 +1,252 @@
+#include "lilia/model/tt_memory.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define LILIA_TT_MMAP 1
+#endif
+
+namespace lilia::model {
+
+namespace {
+constexpr std::size_t KB = 1024;
+constexpr std::size_t MB2 = 2 * 1024 * KB;
+constexpr std::size_t GB1 = 1024 * 1024 * KB;
+
+inline std::size_t round_up(std::size_t x, std::size_t a) {
+  return (x + a - 1) / a * a;
+}
+
+#if defined(LILIA_TT_MMAP)
+inline void* try_mmap(std::size_t len, int extraFlags) {
+  void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | extraFlags,
+                   -1, 0);
+  return p == MAP_FAILED ? nullptr : p;
+}
+#endif
+}  // namespace
+
+void* TTMemory::allocate(std::size_t bytes, bool largePages) {
+  release();
+  if (bytes == 0) bytes = 1;
+  bytes_ = bytes;
+
+#if defined(LILIA_TT_MMAP)
+#if defined(MAP_HUGETLB)
+  if (largePages) {
+    // Explizite hugetlb-Seiten: nur erfolgreich, wenn der Admin einen Pool reserviert hat.
+#if defined(MAP_HUGE_SHIFT)
+    if (bytes >= GB1) {
+      const std::size_t len = round_up(bytes, GB1);
+      if (void* p = try_mmap(len, MAP_HUGETLB | (30 << MAP_HUGE_SHIFT))) {
+        base_ = ptr_ = p;
+        mapLen_ = len;
+        kind_ = PageKind::Huge1G;
+        mapped_ = true;
+        return ptr_;
+      }
+    }
+    const int huge2m = MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+#else
+    const int huge2m = MAP_HUGETLB;
+#endif
+    const std::size_t len = round_up(bytes, MB2);
+    if (void* p = try_mmap(len, huge2m)) {
+      base_ = ptr_ = p;
+      mapLen_ = len;
+      kind_ = PageKind::Huge2M;
+      mapped_ = true;
+      return ptr_;
+    }
+  }
+#endif
+  // Anonyme Abbildung; bei largePages auf 2 MB ausrichten, damit THP greifen kann.
+  const std::size_t align = largePages ? MB2 : 0;
+  const std::size_t len = round_up(bytes, largePages ? MB2 : 4 * KB) + align;
+  if (void* p = try_mmap(len, 0)) {
+    const auto raw = reinterpret_cast<std::uintptr_t>(p);
+    const auto aligned = align ? round_up(raw, align) : raw;
+    base_ = p;
+    ptr_ = reinterpret_cast<void*>(aligned);
+    mapLen_ = len;
+    mapped_ = true;
+    kind_ = PageKind::Default;
+#if defined(MADV_HUGEPAGE)
+    if (largePages && ::madvise(ptr_, round_up(bytes, MB2), MADV_HUGEPAGE) == 0)
+      kind_ = PageKind::Transparent;
+#endif
+    return ptr_;
+  }
+#elif defined(_WIN32)
+  if (largePages) {
+    // Benötigt SeLockMemoryPrivilege; ohne das schlägt der Aufruf einfach fehl.
+    const SIZE_T large = GetLargePageMinimum();
+    if (large > 0) {
+      const std::size_t len = round_up(bytes, large);
+      if (void* p = VirtualAlloc(nullptr, len, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                 PAGE_READWRITE)) {
+        base_ = ptr_ = p;
+        mapLen_ = len;
+        kind_ = PageKind::Huge2M;
+        mapped_ = true;
+        return ptr_;
+      }
+    }
+  }
+  if (void* p = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE)) {
+    base_ = ptr_ = p;
+    mapLen_ = bytes;
+    kind_ = PageKind::Default;
+    mapped_ = true;
+    return ptr_;
+  }
+#endif
+
+  // Letzter Fallback: ausgerichteter Heap-Speicher
+  base_ = ptr_ = ::operator new(round_up(bytes, 64), std::align_val_t{64}, std::nothrow);
+  mapLen_ = round_up(bytes, 64);
+  kind_ = PageKind::Default;
+  mapped_ = false;
+  if (!ptr_) bytes_ = 0;
+  return ptr_;
+}
+
+void* TTMemory::map_file(const char* path, std::size_t offset, std::size_t bytes) {
+  TTMemory next;
+  next.bytes_ = bytes;
+  next.kind_ = PageKind::FileMapped;
+#if defined(LILIA_TT_MMAP)
+  const int fd = ::open(path, O_RDONLY);
+  if (fd < 0) return nullptr;
+  struct stat st {};
+  const std::size_t len = offset + bytes;
+  if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < len) {
+    ::close(fd);
+    return nullptr;
+  }
+  // MAP_PRIVATE: Seiten kommen lazy aus dem Page Cache, Schreibzugriffe kopieren sie
+  void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // die Abbildung hält die Datei selbst offen
+  if (p == MAP_FAILED) return nullptr;
+  next.base_ = p;
+  next.ptr_ = static_cast<char*>(p) + offset;
+  next.mapLen_ = len;
+  next.mapped_ = true;
+#elif defined(_WIN32)
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return nullptr;
+  LARGE_INTEGER size{};
+  const std::size_t len = offset + bytes;
+  if (!GetFileSizeEx(file, &size) || static_cast<std::size_t>(size.QuadPart) < len) {
+    CloseHandle(file);
+    return nullptr;
+  }
+  HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  CloseHandle(file);
+  if (!mapping) return nullptr;
+  void* p = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, len);
+  CloseHandle(mapping);  // die View hält das Mapping am Leben
+  if (!p) return nullptr;
+  next.base_ = p;
+  next.ptr_ = static_cast<char*>(p) + offset;
+  next.mapLen_ = len;
+  next.mapped_ = true;
+  next.fileView_ = true;
+#else
+  std::FILE* f = std::fopen(path, "rb");
+  if (!f) return nullptr;
+  void* p = next.allocate(bytes, false);
+  const bool ok = p && std::fseek(f, static_cast<long>(offset), SEEK_SET) == 0 &&
+                  std::fread(p, 1, bytes, f) == bytes;
+  std::fclose(f);
+  if (!ok) return nullptr;
+  next.kind_ = PageKind::FileMapped;
+#endif
+  swap(next);  // alter Block wird mit next freigegeben
+  return ptr_;
+}
+
+void TTMemory::swap(TTMemory& other) noexcept {
+  std::swap(ptr_, other.ptr_);
+  std::swap(base_, other.base_);
+  std::swap(mapLen_, other.mapLen_);
+  std::swap(bytes_, other.bytes_);
+  std::swap(kind_, other.kind_);
+  std::swap(mapped_, other.mapped_);
+  std::swap(fileView_, other.fileView_);
+}
+
+void TTMemory::release() noexcept {
+  if (base_) {
+    if (mapped_) {
+#if defined(LILIA_TT_MMAP)
+      ::munmap(base_, mapLen_);
+#elif defined(_WIN32)
+      if (fileView_)
+        UnmapViewOfFile(base_);
+      else
+        VirtualFree(base_, 0, MEM_RELEASE);
+#endif
+    } else {
+      ::operator delete(base_, std::align_val_t{64});
+    }
+  }
+  ptr_ = base_ = nullptr;
+  mapLen_ = bytes_ = 0;
+  kind_ = PageKind::Default;
+  mapped_ = false;
+  fileView_ = false;
+}
+
+std::size_t TTMemory::page_size() const noexcept {
+  switch (kind_) {
+    case PageKind::Huge1G:
+      return GB1;
+    case PageKind::Huge2M:
+    case PageKind::Transparent:
+      return MB2;
+    default:
+      break;
+  }
+#if defined(LILIA_TT_MMAP)
+  const long ps = ::sysconf(_SC_PAGESIZE);
+  return ps > 0 ? static_cast<std::size_t>(ps) : 4 * KB;
+#else
+  return 4 * KB;
+#endif
+}
+
+const char* TTMemory::page_description() const noexcept {
+  switch (kind_) {
+    case PageKind::Huge1G:
+      return "1 GB (hugetlb)";
+    case PageKind::Huge2M:
+#if defined(_WIN32)
+      return "large pages";
+#else
+      return "2 MB (hugetlb)";
+#endif
+    case PageKind::Transparent:
+      return "2 MB (transparent, madvise)";
+    case PageKind::FileMapped:
+      return "file (copy-on-write mapping)";
+    default:
+      return "default";
+  }
+}
+
+}  // namespace lilia::model
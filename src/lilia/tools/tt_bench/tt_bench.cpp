@@ -0,0 +1,142 @@
+// tt_bench – Hit-Rate der TT in Abhängigkeit von der konfigurierten Größe.
+//
+// Läuft einen deterministischen Baum (alle legalen Züge bis Tiefe N) über ein paar feste
+// Stellungen und nutzt die TT wie ein Perft-Hash: Treffer mit ausreichender Resttiefe
+// schneiden den Teilbaum ab. Dadurch hängen Hit-Rate und Knotenzahl direkt davon ab,
+// wie viel der angeforderten Hash-Größe tatsächlich genutzt wird.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "lilia/engine/engine.hpp"
+#include "lilia/model/chess_game.hpp"
+#include "lilia/model/move_generator.hpp"
+#include "lilia/model/tt5.hpp"
+
+namespace lilia::tools::ttbench {
+
+namespace {
+
+const char* const kFens[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+};
+
+struct Counters {
+  std::uint64_t nodes = 0;
+  std::uint64_t probes = 0;
+  std::uint64_t hits = 0;     // Key gefunden
+  std::uint64_t cutoffs = 0;  // Key gefunden und Resttiefe reicht
+};
+
+void walk(model::Position& pos, model::TT5& tt, model::MoveGenerator& mg,
+          std::vector<std::vector<model::Move>>& lists, int depth, int ply, Counters& c) {
+  ++c.nodes;
+  if (depth == 0) return;
+
+  ++c.probes;
+  model::TTEntry5 e;
+  if (tt.probe_into(pos.hash(), e)) {
+    ++c.hits;
+    if (e.depth >= depth) {
+      ++c.cutoffs;
+      return;
+    }
+  }
+
+  auto& moves = lists[ply];
+  moves.clear();
+  mg.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), moves);
+  for (const auto& m : moves) {
+    if (!pos.doMove(m)) continue;
+    walk(pos, tt, mg, lists, depth - 1, ply + 1, c);
+    pos.undoMove();
+  }
+  tt.store(pos.hash(), 0, static_cast<int16_t>(depth), model::Bound::Exact, model::Move{});
+}
+
+std::vector<std::size_t> parse_sizes(const std::string& s) {
+  std::vector<std::size_t> out;
+  std::istringstream iss(s);
+  std::string tok;
+  while (std::getline(iss, tok, ','))
+    if (!tok.empty()) out.push_back(static_cast<std::size_t>(std::stoull(tok)));
+  return out;
+}
+
+void usage() {
+  std::cerr << "usage: tt_bench [--sizes 1,2,3,...] [--depth N]\n"
+               "  Walks all legal moves to depth N over fixed positions, using the TT\n"
+               "  as a perft hash, and prints the hit rate per configured hash size (MB).\n";
+}
+
+}  // namespace
+
+int run(int argc, char** argv) {
+  std::vector<std::size_t> sizes = {1, 2, 3, 4, 6, 8, 12, 16};
+  int depth = 5;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--sizes" && i + 1 < argc) {
+      sizes = parse_sizes(argv[++i]);
+    } else if (arg == "--depth" && i + 1 < argc) {
+      depth = std::max(1, std::atoi(argv[++i]));
+    } else {
+      usage();
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  engine::Engine::init();
+
+  std::vector<model::ChessGame> games(std::size(kFens));
+  for (std::size_t i = 0; i < games.size(); ++i) games[i].setPosition(kFens[i]);
+
+  std::cout << "depth " << depth << ", " << games.size() << " positions\n";
+  std::cout << std::left << std::setw(8) << "MB" << std::setw(10) << "used MB" << std::setw(12)
+            << "clusters" << std::setw(12) << "nodes" << std::setw(10) << "hit%"
+            << std::setw(10) << "cut%" << "ms\n";
+
+  model::MoveGenerator mg;
+  std::vector<std::vector<model::Move>> lists(depth + 1);
+  for (auto& l : lists) l.reserve(256);
+
+  for (std::size_t mb : sizes) {
+    model::TT5 tt(mb);
+    Counters c;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (auto& g : games) {
+      model::Position pos = g.getPositionRefForBot();
+      walk(pos, tt, mg, lists, depth, 0, c);
+    }
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - t0)
+                        .count();
+
+    const double hitPct = c.probes ? 100.0 * double(c.hits) / double(c.probes) : 0.0;
+    const double cutPct = c.probes ? 100.0 * double(c.cutoffs) / double(c.probes) : 0.0;
+    std::cout << std::left << std::setw(8) << mb << std::setw(10) << std::fixed
+              << std::setprecision(1) << double(tt.size_bytes()) / (1024.0 * 1024.0)
+              << std::setw(12) << tt.slots() << std::setw(12) << c.nodes << std::setw(10)
+              << std::setprecision(2) << hitPct << std::setw(10) << cutPct << ms << "\n";
+  }
+  return 0;
+}
+
+}  // namespace lilia::tools::ttbench
+
+int main(int argc, char** argv) {
+  return lilia::tools::ttbench::run(argc, argv);
+}
@@ -0,0 +1,312 @@
+// tt_replay – vergleicht TT-Layouts an aufgezeichneten Probe/Store-Strömen echter Suchen.
+//
+//   tt_replay record <file> [--depth N] [--hash MB]
+//       Sucht ein paar feste Stellungen (1 Thread) und schreibt jeden TT-Zugriff mit.
+//   tt_replay replay <file> [--sizes 1,4,16] [--threads N]
+//       Spielt den Strom gegen jedes Layout ab: Hit-Rate, Kollisionen, Torn Reads, ns/probe.
+//
+// Beim Abspielen werden value/staticEval aus (key, depth, bound) abgeleitet statt
+// aufgezeichnet. So lässt sich jeder Treffer prüfen:
+//   value passt nicht zum key           -> Eintrag gehört einer anderen Stellung (coll%)
+//   value passt, staticEval nicht       -> Felder aus zwei Stores gemischt (torn%)
+// Mit --threads N spielen N Threads denselben Strom versetzt gegen eine gemeinsame TT.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lilia/engine/config.hpp"
+#include "lilia/engine/engine.hpp"
+#include "lilia/model/chess_game.hpp"
+#include "lilia/model/tt5.hpp"
+
+#if !TT5_RECORD
+#error "tt_replay must be built with TT5_RECORD=1"
+#endif
+
+namespace lilia::tools::ttreplay {
+
+namespace {
+
+const char* const kFens[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "6k1/3b1ppp/p7/3R4/2P2p2/7q/4KQ2/8 b - - 1 66",
+};
+
+enum OpKind : std::uint8_t { OP_PROBE = 0, OP_STORE = 1, OP_NEWGEN = 2 };
+
+// 16 bytes on disk, native byte order
+struct Op {
+  std::uint64_t key;
+  std::uint16_t move;
+  std::uint8_t depth;
+  std::uint8_t kindBound;  // [1..0] kind, [3..2] bound
+  std::uint32_t reserved;
+};
+static_assert(sizeof(Op) == 16);
+
+constexpr char kMagic[8] = {'L', 'T', 'T', 'R', 'E', 'C', '0', '1'};
+
+class StreamRecorder final : public model::TTRecorder {
+ public:
+  void on_probe(std::uint64_t key, bool) override { ops.push_back({key, 0, 0, OP_PROBE, 0}); }
+  void on_store(std::uint64_t key, int32_t, int16_t depth, model::Bound bound,
+                std::uint16_t move16, int16_t) override {
+    ops.push_back({key, move16, static_cast<std::uint8_t>(depth),
+                   static_cast<std::uint8_t>(OP_STORE | (static_cast<std::uint8_t>(bound) << 2)),
+                   0});
+  }
+  void on_new_generation() override { ops.push_back({0, 0, 0, OP_NEWGEN, 0}); }
+
+  std::vector<Op> ops;
+};
+
+bool write_stream(const std::string& path, const std::vector<Op>& ops) {
+  std::ofstream out(path, std::ios::binary);
+  if (!out) return false;
+  const std::uint64_t n = ops.size();
+  out.write(kMagic, sizeof(kMagic));
+  out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+  out.write(reinterpret_cast<const char*>(ops.data()), std::streamsize(n * sizeof(Op)));
+  return bool(out);
+}
+
+bool read_stream(const std::string& path, std::vector<Op>& ops) {
+  std::ifstream in(path, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  std::uint64_t n = 0;
+  if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    return false;
+  if (!in.read(reinterpret_cast<char*>(&n), sizeof(n))) return false;
+  ops.resize(n);
+  return bool(in.read(reinterpret_cast<char*>(ops.data()), std::streamsize(n * sizeof(Op))));
+}
+
+inline std::uint64_t mix64(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xFF51AFD7ED558CCDull;
+  x ^= x >> 33;
+  x *= 0xC4CEB9FE1A85EC53ull;
+  x ^= x >> 33;
+  return x;
+}
+inline std::int16_t value_for(std::uint64_t key) {
+  return static_cast<std::int16_t>(mix64(key));
+}
+inline std::int16_t eval_for(std::uint64_t key, unsigned depth, unsigned bound) {
+  return static_cast<std::int16_t>(mix64(key ^ ((depth << 2 | bound) * 0x9E3779B97F4A7C15ull)));
+}
+
+struct Result {
+  std::uint64_t probes = 0;
+  std::uint64_t hits = 0;
+  std::uint64_t collisions = 0;
+  std::uint64_t torn = 0;
+  double nsPerProbe = 0.0;
+  std::size_t clusters = 0;
+};
+
+template <class TT>
+void replay_range(TT& tt, const std::vector<Op>& ops, std::size_t begin, Result& r,
+                  bool applyNewGen) {
+  const std::size_t n = ops.size();
+  for (std::size_t k = 0; k < n; ++k) {
+    const Op& op = ops[(begin + k) % n];
+    switch (op.kindBound & 3u) {
+      case OP_PROBE: {
+        ++r.probes;
+        model::TTEntry5 e;
+        if (!tt.probe_into(op.key, e)) break;
+        ++r.hits;
+        if (static_cast<std::int16_t>(e.value) != value_for(op.key))
+          ++r.collisions;
+        else if (e.staticEval != eval_for(op.key, unsigned(e.depth), unsigned(e.bound)))
+          ++r.torn;
+        break;
+      }
+      case OP_STORE: {
+        const unsigned bound = (op.kindBound >> 2) & 3u;
+        model::Move mv{};
+        mv.set_from(static_cast<core::Square>(op.move & 0x3F));
+        mv.set_to(static_cast<core::Square>((op.move >> 6) & 0x3F));
+        tt.store(op.key, value_for(op.key), op.depth, static_cast<model::Bound>(bound), mv,
+                 eval_for(op.key, op.depth, bound));
+        break;
+      }
+      case OP_NEWGEN:
+        if (applyNewGen) tt.new_generation();
+        break;
+    }
+  }
+}
+
+template <class Layout>
+Result run_layout(const std::vector<Op>& ops, std::size_t mb, int threads) {
+  model::BasicTT5<Layout> tt(mb);
+  Result r;
+  r.clusters = tt.slots();
+
+  if (threads <= 1) {
+    replay_range(tt, ops, 0, r, true);
+  } else {
+    std::vector<Result> parts(threads);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+      pool.emplace_back([&, t] {
+        // only thread 0 ages the table, like the main thread of a search
+        replay_range(tt, ops, ops.size() * std::size_t(t) / std::size_t(threads), parts[t],
+                     t == 0);
+      });
+    for (auto& th : pool) th.join();
+    for (const auto& p : parts) {
+      r.probes += p.probes;
+      r.hits += p.hits;
+      r.collisions += p.collisions;
+      r.torn += p.torn;
+    }
+  }
+
+  // ns/probe: probe-only pass over the warm table
+  volatile std::uint64_t sink = 0;  // keeps the probe loop alive
+  std::uint64_t n = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (const Op& op : ops) {
+    if ((op.kindBound & 3u) != OP_PROBE) continue;
+    model::TTEntry5 e;
+    sink = sink + (tt.probe_into(op.key, e) ? e.depth : 0);
+    ++n;
+  }
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - t0)
+                      .count();
+  r.nsPerProbe = n ? double(ns) / double(n) : 0.0;
+  return r;
+}
+
+template <class Layout>
+void report(const std::vector<Op>& ops, std::size_t mb, int threads) {
+  const Result r = run_layout<Layout>(ops, mb, threads);
+  auto pct = [&](std::uint64_t x) { return r.probes ? 100.0 * double(x) / double(r.probes) : 0.0; };
+  std::cout << std::left << std::setw(10) << Layout::kName << std::setw(8) << mb << std::setw(12)
+            << r.clusters * Layout::kEntries << std::fixed << std::setprecision(2)
+            << std::setw(10) << pct(r.hits) << std::setprecision(4) << std::setw(10)
+            << pct(r.collisions) << std::setw(10) << pct(r.torn) << std::setprecision(1)
+            << r.nsPerProbe << "\n";
+}
+
+std::vector<std::size_t> parse_sizes(const std::string& s) {
+  std::vector<std::size_t> out;
+  std::istringstream iss(s);
+  std::string tok;
+  while (std::getline(iss, tok, ','))
+    if (!tok.empty()) out.push_back(static_cast<std::size_t>(std::stoull(tok)));
+  return out;
+}
+
+void usage() {
+  std::cerr << "usage: tt_replay record <file> [--depth N] [--hash MB]\n"
+               "       tt_replay replay <file> [--sizes 1,4,16] [--threads N]\n"
+               "  record: searches fixed positions single-threaded and saves every TT access\n"
+               "  replay: replays the stream against each TT layout and prints hit rate,\n"
+               "          wrong-position hits (coll%), mixed-store hits (torn%) and ns/probe\n";
+}
+
+int record(const std::string& path, int depth, std::size_t hashMb) {
+  engine::EngineConfig cfg;
+  cfg.threads = 1;
+  cfg.ttSizeMb = hashMb;
+  engine::Engine engine(cfg);
+
+  StreamRecorder rec;
+  model::tt_recorder = &rec;
+  for (const char* fen : kFens) {
+    model::ChessGame game;
+    game.setPosition(fen);
+    model::Position pos = game.getPositionRefForBot();
+    (void)engine.find_best_move(pos, depth);
+  }
+  model::tt_recorder = nullptr;
+
+  if (!write_stream(path, rec.ops)) {
+    std::cerr << "cannot write " << path << "\n";
+    return 1;
+  }
+  const auto probes = std::count_if(rec.ops.begin(), rec.ops.end(),
+                                    [](const Op& o) { return (o.kindBound & 3u) == OP_PROBE; });
+  std::cout << "recorded " << rec.ops.size() << " ops (" << probes << " probes) from "
+            << std::size(kFens) << " positions at depth " << depth << " -> " << path << "\n";
+  return 0;
+}
+
+int replay(const std::string& path, const std::vector<std::size_t>& sizes, int threads) {
+  std::vector<Op> ops;
+  if (!read_stream(path, ops)) {
+    std::cerr << "cannot read " << path << "\n";
+    return 1;
+  }
+  std::cout << ops.size() << " ops, " << threads << " thread(s)\n";
+  std::cout << std::left << std::setw(10) << "layout" << std::setw(8) << "MB" << std::setw(12)
+            << "entries" << std::setw(10) << "hit%" << std::setw(10) << "coll%"
+            << std::setw(10) << "torn%" << "ns/probe\n";
+  for (std::size_t mb : sizes) {
+    report<model::TTLayoutPacked4>(ops, mb, threads);
+    report<model::TTLayoutCompact6>(ops, mb, threads);
+  }
+  return 0;
+}
+
+}  // namespace
+
+int run(int argc, char** argv) {
+  if (argc < 3) {
+    usage();
+    return 1;
+  }
+  const std::string mode = argv[1];
+  const std::string path = argv[2];
+  int depth = 10;
+  std::size_t hashMb = 64;
+  int threads = 1;
+  std::vector<std::size_t> sizes = {1, 4, 16};
+  for (int i = 3; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--depth" && i + 1 < argc) {
+      depth = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--hash" && i + 1 < argc) {
+      hashMb = static_cast<std::size_t>(std::max(1, std::atoi(argv[++i])));
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads = std::max(1, std::atoi(argv[++i]));
+    } else if (arg == "--sizes" && i + 1 < argc) {
+      sizes = parse_sizes(argv[++i]);
+    } else {
+      usage();
+      return 1;
+    }
+  }
+
+  engine::Engine::init();
+  if (mode == "record") return record(path, depth, hashMb);
+  if (mode == "replay") return replay(path, sizes, threads);
+  usage();
+  return 1;
+}
+
+}  // namespace lilia::tools::ttreplay
+
+int main(int argc, char** argv) {
+  return lilia::tools::ttreplay::run(argc, argv);
+}
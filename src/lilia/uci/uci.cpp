@@ -4,7 +4,10 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <future>
+#include <iomanip>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -12,9 +15,13 @@
 #include <thread>
 #include <vector>
 
+#include "lilia/engine/bench.hpp"
 #include "lilia/engine/bot_engine.hpp"
+#include "lilia/engine/perft.hpp"
+#include "lilia/log/log.hpp"
 #include "lilia/model/chess_game.hpp"
 #include "lilia/uci/uci_helper.hpp"
+#include "lilia/uci/uci_output.hpp"
 
 namespace lilia {
 
@@ -36,54 +43,186 @@ static std::string extract_fen_after(const std::string& line) {
   return line.substr(pos, moves_pos - pos);
 }
 
+// Everything after the command word, trimmed (paths may contain spaces)
+static std::string rest_after(const std::string& line, const std::string& cmd) {
+  auto pos = line.find(cmd);
+  if (pos == std::string::npos) return "";
+  pos += cmd.size();
+  while (pos < line.size() && isspace((unsigned char)line[pos])) ++pos;
+  auto end = line.size();
+  while (end > pos && isspace((unsigned char)line[end - 1])) --end;
+  return line.substr(pos, end - pos);
+}
+
+// UCI-Zug in Koordinatennotation ("e2e4", "e7e8q"), um searchmoves vom Rest zu trennen
+static bool is_move_token(const std::string& t) {
+  auto file = [](char c) { return c >= 'a' && c <= 'h'; };
+  auto rank = [](char c) { return c >= '1' && c <= '8'; };
+  if (t.size() != 4 && t.size() != 5) return false;
+  return file(t[0]) && rank(t[1]) && file(t[2]) && rank(t[3]);
+}
+
+// "score cp x" bzw. "score mate n" (n in Zügen, negativ = wir werden matt)
+static std::string uci_score(int s) {
+  if (s >= engine::MATE_THR) return "mate " + std::to_string((engine::MATE - s + 1) / 2);
+  if (s <= -engine::MATE_THR) return "mate " + std::to_string(-((engine::MATE + s) / 2));
+  return "cp " + std::to_string(s);
+}
+
+// Läuft im Such-Thread: nur formatieren und einreihen
+// Läuft in den Such-Threads: nur uci_info(), die Suche wartet nie auf die GUI
+static void print_iteration_info(const engine::SearchInfo& si) {
+  if (si.currmoveNumber > 0) {
+    uci_info() << "info depth " << si.depth << " currmove " << move_to_uci(si.currmove)
+              << " currmovenumber " << si.currmoveNumber << "\n";
+    return;
+  }
+  UciLine line{true};
+  line << "info depth " << si.depth << " seldepth " << si.seldepth << " multipv " << si.multipv
+       << " score " << uci_score(si.score) << " nodes " << si.nodes << " nps " << si.nps
+       << " hashfull " << si.hashfull << " time " << si.timeMs;
+  if (!si.pv.empty()) {
+    line << " pv";
+    for (const auto& m : si.pv) line << " " << move_to_uci(m);
+  }
+  line << "\n";
+}
+
+// Final search summary: nodes/time/hashfull as UCI info, TT counters as info string.
+// Vom Printer-Thread direkt vor bestmove, darf also auf die GUI warten.
+static void print_search_info(const engine::SearchStats& st) {
+  // Verworfene Zwischenstände (GUI las nicht mit) einmal je Suche melden
+  static std::uint64_t reportedDrops = 0;
+  if (const auto d = log::Channel::instance().info_dropped(); d != reportedDrops) {
+    LILIA_LOG(Warn, Uci) << (d - reportedDrops) << " info lines dropped, GUI not reading";
+    reportedDrops = d;
+  }
+  uci_out() << "info nodes " << st.nodes << " time " << st.elapsedMs << " nps "
+            << static_cast<long long>(st.nps) << " hashfull " << st.hashfull << "\n";
+  const auto& t = st.tt;
+  if (t.probes == 0 && t.stores == 0) return;  // TT5_STATS=0
+  std::ostringstream os;
+  os.setf(std::ios::fixed);
+  os.precision(1);
+  os << "info string tt probes " << t.probes << " hit " << 100.0 * t.hit_rate() << "% keymiss "
+     << 100.0 * t.collision_rate() << "% stores " << t.stores << " empty " << t.emptyWrites
+     << " samekey " << t.sameKeyWrites << " stale " << t.replacedStale << " shallow "
+     << t.replacedShallow << " rejected " << t.rejected << "\n";
+  uci_out() << os.str();
+}
+
+UCI::UCI() = default;
+UCI::~UCI() = default;
+
+engine::BotEngine& UCI::engineSession() {
+  if (!m_engine) {
+    m_engine = std::make_unique<engine::BotEngine>(m_options.toEngineConfig());
+    m_engine->setInfoCallback(print_iteration_info);
+    reportHash();
+  }
+  return *m_engine;
+}
+
+void UCI::reportHash() {
+  if (!m_engine) return;
+  uci_out() << "info string hash " << m_engine->getConfig().ttSizeMb << " MB, pages "
+            << m_engine->ttPageDescription() << "\n";
+}
+
+void UCI::setPosition(const std::string& line) {
+  std::string base;
+  if (line.find("startpos") != std::string::npos) {
+    base = core::START_FEN;
+  } else if (line.find("fen") != std::string::npos) {
+    base = extract_fen_after(line);
+  }
+
+  std::vector<std::string> moves;
+  auto posMoves = line.find("moves");
+  if (posMoves != std::string::npos) moves = split_ws(line.substr(posMoves + 5));
+
+  // Same base and the old move list is a prefix: only the tail is new (usual GUI case)
+  const bool extends = !m_posBase.empty() && base == m_posBase &&
+                       moves.size() >= m_posMoves.size() &&
+                       std::equal(m_posMoves.begin(), m_posMoves.end(), moves.begin());
+  std::size_t first = m_posMoves.size();
+  if (!extends) {
+    if (!base.empty()) m_game.setPosition(base);
+    m_posBase = base;
+    m_posMoves.clear();
+    first = 0;
+  }
+
+  for (std::size_t i = first; i < moves.size(); ++i) {
+    bool ok = false;
+    try {
+      ok = m_game.doMoveUCI(moves[i]);
+    } catch (...) {
+    }
+    if (!ok) {
+      LILIA_LOG(Warn, Uci) << "applyMoveUCI failed for " << moves[i];
+      m_posBase.clear();  // m_game no longer matches the move list: rebuild next time
+      continue;
+    }
+    m_posMoves.push_back(moves[i]);
+  }
+}
+
 void UCI::showOptions() {
   const auto& c = m_options.cfg;
-  std::cout << "option name Hash type spin default " << c.ttSizeMb << " min 1 max 131072\n";
-  std::cout << "option name Threads type spin default " << c.threads << " min 1 max 64\n";
-  std::cout << "option name Max Depth type spin default " << c.maxDepth << " min 1 max "
+  uci_out() << "option name Hash type spin default " << c.ttSizeMb << " min 1 max 131072\n";
+  uci_out() << "option name Large Pages type check default "
+            << (c.ttLargePages ? "true" : "false") << "\n";
+  uci_out() << "option name Threads type spin default " << c.threads << " min 1 max 64\n";
+  uci_out() << "option name MultiPV type spin default " << c.multiPV << " min 1 max 256\n";
+  uci_out() << "option name Max Depth type spin default " << c.maxDepth << " min 1 max "
             << engine::MAX_PLY << "\n";
-  std::cout << "option name Max Nodes type spin default " << c.maxNodes
+  uci_out() << "option name Max Nodes type spin default " << c.maxNodes
             << " min 0 max 1000000000\n";
-  std::cout << "option name Use Null Move type check default "
+  uci_out() << "option name Use Null Move type check default "
             << (c.useNullMove ? "true" : "false") << "\n";
-  std::cout << "option name Use LMR type check default "
+  uci_out() << "option name Use LMR type check default "
             << (c.useLMR ? "true" : "false") << "\n";
-  std::cout << "option name Use Aspiration type check default "
+  uci_out() << "option name Use Aspiration type check default "
             << (c.useAspiration ? "true" : "false") << "\n";
-  std::cout << "option name Aspiration Window type spin default " << c.aspirationWindow
+  uci_out() << "option name Aspiration Window type spin default " << c.aspirationWindow
             << " min 1 max 1000\n";
-  std::cout << "option name Use LMP type check default "
+  uci_out() << "option name Use LMP type check default "
             << (c.useLMP ? "true" : "false") << "\n";
-  std::cout << "option name Use IID type check default "
+  uci_out() << "option name Use IID type check default "
             << (c.useIID ? "true" : "false") << "\n";
-  std::cout << "option name Use Singular Extension type check default "
+  uci_out() << "option name Use Singular Extension type check default "
             << (c.useSingularExt ? "true" : "false") << "\n";
-  std::cout << "option name LMP Depth Max type spin default " << c.lmpDepthMax
+  uci_out() << "option name LMP Depth Max type spin default " << c.lmpDepthMax
             << " min 0 max 10\n";
-  std::cout << "option name LMP Base type spin default " << c.lmpBase
+  uci_out() << "option name LMP Base type spin default " << c.lmpBase
             << " min 0 max 10\n";
-  std::cout << "option name Use Futility type check default "
+  uci_out() << "option name Use Futility type check default "
             << (c.useFutility ? "true" : "false") << "\n";
-  std::cout << "option name Futility Margin type spin default " << c.futilityMargin
+  uci_out() << "option name Futility Margin type spin default " << c.futilityMargin
             << " min 0 max 1000\n";
-  std::cout << "option name Use Reverse Futility type check default "
+  uci_out() << "option name Use Reverse Futility type check default "
             << (c.useReverseFutility ? "true" : "false") << "\n";
-  std::cout << "option name Use SEE Pruning type check default "
+  uci_out() << "option name Use SEE Pruning type check default "
             << (c.useSEEPruning ? "true" : "false") << "\n";
-  std::cout << "option name Use Prob Cut type check default "
+  uci_out() << "option name Use Prob Cut type check default "
             << (c.useProbCut ? "true" : "false") << "\n";
-  std::cout << "option name Qsearch Quiet Checks type check default "
+  uci_out() << "option name Qsearch Quiet Checks type check default "
             << (c.qsearchQuietChecks ? "true" : "false") << "\n";
-  std::cout << "option name LMR Base type spin default " << c.lmrBase
+  uci_out() << "option name LMR Base type spin default " << c.lmrBase
             << " min 0 max 10\n";
-  std::cout << "option name LMR Max type spin default " << c.lmrMax
+  uci_out() << "option name LMR Max type spin default " << c.lmrMax
             << " min 0 max 10\n";
-  std::cout << "option name LMR Use History type check default "
+  uci_out() << "option name LMR Use History type check default "
             << (c.lmrUseHistory ? "true" : "false") << "\n";
-  std::cout << "option name Ponder type check default "
+  uci_out() << "option name Ponder type check default "
             << (m_options.ponder ? "true" : "false") << "\n";
-  std::cout << "option name Move Overhead type spin default " << m_options.moveOverhead
+  uci_out() << "option name Move Overhead type spin default " << m_options.moveOverhead
             << " min 0 max 5000\n";
+  // Diagnosen (stderr), getrennt vom Protokoll
+  uci_out() << "option name Log Level type combo default warn var off var error var warn var info"
+               " var debug\n";
+  uci_out() << "option name Log Categories type string default all\n";
 }
 
 void UCI::setOption(const std::string& line) {
@@ -122,10 +261,15 @@ void UCI::setOption(const std::string& line) {
     int v = std::stoi(value);
     v = std::max(1, std::min(131072, v));
     m_options.cfg.ttSizeMb = v;
+  } else if (name == "Large Pages") {
+    m_options.cfg.ttLargePages = to_bool(value);
   } else if (name == "Threads") {
     int v = std::stoi(value);
     v = std::max(1, std::min(64, v));
     m_options.cfg.threads = v;
+  } else if (name == "MultiPV") {
+    int v = std::stoi(value);
+    m_options.cfg.multiPV = std::max(1, std::min(256, v));
   } else if (name == "Max Depth") {
     int v = std::stoi(value);
     v = std::max(1, std::min(engine::MAX_PLY, v));
@@ -193,18 +337,119 @@ void UCI::setOption(const std::string& line) {
   } else if (name == "Move Overhead") {
     int v = std::stoi(value);
     m_options.moveOverhead = std::max(0, v);
+  } else if (name == "Log Level") {
+    log::Level lv;
+    if (log::parse_level(value, lv))
+      log::set_level(lv);
+    else
+      uci_out() << "info string unknown log level " << value << "\n";
+  } else if (name == "Log Categories") {
+    std::uint32_t mask = 0;
+    if (log::parse_categories(value, mask))
+      log::set_categories(mask);
+    else
+      uci_out() << "info string unknown log category in " << value
+                << " (general, search, uci, tt, time, all, none)\n";
+  }
+
+  // Laufende Session übernimmt die Optionen; TT wird nur bei geänderter Hash-Größe neu angelegt
+  if (m_engine) {
+    m_engine->setConfig(m_options.toEngineConfig());
+    if (name == "Hash" || name == "Large Pages") reportHash();
   }
 }
 
+int UCI::bench(const std::vector<std::string>& args) {
+  auto arg = [&](std::size_t i, long long def) -> long long {
+    if (i >= args.size()) return def;
+    try {
+      return std::stoll(args[i]);
+    } catch (...) {
+      return def;
+    }
+  };
+  // Session-Optionen als Basis; eigene Engine, damit TT und Histories der Session unberührt
+  // bleiben und die Signatur nicht vom Vorlauf abhängt
+  engine::EngineConfig cfg = m_options.toEngineConfig();
+  const int depth = static_cast<int>(std::max(1LL, arg(0, engine::BENCH_DEPTH)));
+  cfg.threads = static_cast<int>(std::max(1LL, arg(1, engine::BENCH_THREADS)));
+  cfg.ttSizeMb = static_cast<std::size_t>(std::max(1LL, arg(2, (long long)engine::BENCH_HASH_MB)));
+
+  const auto r = engine::run_bench(cfg, depth, &log::diagnostic());
+  uci_out() << "===========================\n"
+            << "Total time (ms) : " << r.elapsedMs << "\n"
+            << "Nodes searched  : " << r.nodes << "\n"
+            << "Nodes/second    : " << r.nps << "\n"
+            << "Stop overshoot  : worst " << std::fixed << std::setprecision(2)
+            << r.stopOvershootMaxMs << " ms, avg " << r.stopOvershootAvgMs << " ms ("
+            << r.stopProbes << " x " << engine::BENCH_STOP_MS << " ms)\n";
+  uci_flush();
+  return 0;
+}
+
+// Divide-Liste wie üblich ("e2e4: 20"), danach Summe, Zeit und Knoten pro Sekunde
+static void print_perft(const engine::PerftResult& r) {
+  if (r.stopped) {
+    uci_out() << "info string perft stopped after " << r.elapsedMs << " ms\n";
+    return;
+  }
+  for (const auto& [m, n] : r.divide) uci_out() << move_to_uci(m) << ": " << n << "\n";
+  uci_out() << "\nNodes searched: " << r.nodes << "\n"
+            << "info string perft time " << r.elapsedMs << " nps " << r.nps << "\n";
+}
+
+int UCI::perft(const std::vector<std::string>& args) {
+  engine::Engine::init();
+  int depth = 1;
+  int threads = engine::PERFT_THREADS;
+  try {
+    if (args.size() > 0) depth = std::stoi(args[0]);
+    if (args.size() > 1) threads = std::stoi(args[1]);
+  } catch (...) {
+    std::cerr << "usage: perft <depth> [threads] [fen]\n";
+    return 1;
+  }
+  std::string fen;
+  for (std::size_t i = 2; i < args.size(); ++i) fen += (fen.empty() ? "" : " ") + args[i];
+  m_game.setPosition(fen.empty() ? core::START_FEN : fen);
+
+  print_perft(engine::run_perft(m_game.getPositionRefForBot(), depth, threads));
+  uci_flush();
+  return 0;
+}
+
 int UCI::run() {
   engine::Engine::init();
   std::string line;
 
   std::mutex stateMutex;
-  std::future<lilia::model::Move> searchFuture;
+  std::future<engine::SearchResult> searchFuture;
   std::thread printerThread;
   std::atomic<bool> cancelToken(false);
   bool searchRunning = false;
+  // "go ponder" bis ponderhit/stop: bestmove darf vorher nicht raus, auch wenn die Suche
+  // schon fertig ist (stateMutex)
+  bool pondering = false;
+  std::condition_variable ponderCv;
+
+  auto release_ponder = [&]() {
+    {
+      std::lock_guard<std::mutex> lk(stateMutex);
+      pondering = false;
+    }
+    ponderCv.notify_all();
+  };
+
+  // Laufende Suche abbrechen und warten, bis bestmove raus ist. Der Join passiert
+  // ohne stateMutex, weil der Printer-Thread ihn zum Abschluss selbst nimmt.
+  auto stop_search = [&]() {
+    cancelToken.store(true);
+    release_ponder();
+    if (printerThread.joinable()) printerThread.join();
+    std::lock_guard<std::mutex> lk(stateMutex);
+    searchRunning = false;
+    cancelToken.store(false);
+  };
 
   while (std::getline(std::cin, line)) {
     if (!line.empty() && line.back() == '\r') line.pop_back();
@@ -215,59 +460,71 @@ int UCI::run() {
     const std::string& cmd = tokens[0];
 
     if (cmd == "uci") {
-      std::cout << "id name " << m_name << "\n";
-      std::cout << "id author unknown\n";
-      std::cout << "id version " << m_version << "\n";
+      uci_out() << "id name " << m_name << "\n";
+      uci_out() << "id author unknown\n";
+      uci_out() << "id version " << m_version << "\n";
       showOptions();
-      std::cout << "uciok\n";
+      uci_out() << "uciok\n";
       continue;
     }
 
     if (cmd == "isready") {
-      std::cout << "readyok\n";
+      engineSession();  // TT-Allokation vor dem ersten go erledigen
+      uci_out() << "readyok\n";
       continue;
     }
 
     if (cmd == "setoption") {
+      stop_search();
       setOption(line);
       continue;
     }
 
     if (cmd == "ucinewgame") {
+      stop_search();
+      engineSession().newGame();
       continue;
     }
 
-    if (cmd == "position") {
-      if (line.find("startpos") != std::string::npos) {
-        m_game.setPosition(core::START_FEN);
-      } else if (line.find("fen") != std::string::npos) {
-        std::string fen = extract_fen_after(line);
-        if (!fen.empty()) {
-          m_game.setPosition(fen);
-        }
+    // Nicht-Standard: TT für spätere Analyse-Sessions sichern / wieder einblenden
+    if (cmd == "savehash" || cmd == "loadhash") {
+      const std::string path = rest_after(line, cmd);
+      if (path.empty()) {
+        uci_out() << "info string usage: " << cmd << " <file>\n";
+        continue;
       }
-      auto posMoves = line.find("moves");
-      if (posMoves != std::string::npos) {
-        std::string movesStr = line.substr(posMoves + 6);
-        std::istringstream iss(movesStr);
-        std::string moveUci;
-        while (iss >> moveUci) {
-          try {
-            m_game.doMoveUCI(moveUci);
-          } catch (...) {
-            std::cerr << "[UCI] warning: applyMoveUCI failed for " << moveUci << "\n";
-          }
-        }
+      stop_search();
+      engine::BotEngine& engine = engineSession();
+      if (cmd == "savehash") {
+        const bool ok = engine.saveHash(path);
+        uci_out() << "info string " << (ok ? "hash saved to " : "cannot save hash to ") << path
+                  << "\n";
+      } else if (engine.loadHash(path)) {
+        // Größe der Datei übernehmen, sonst würde das nächste setoption neu allokieren
+        m_options.cfg.ttSizeMb = engine.getConfig().ttSizeMb;
+        uci_out() << "info string hash loaded from " << path << "\n";
+        reportHash();
+      } else {
+        uci_out() << "info string cannot load hash from " << path
+                  << " (missing, truncated or different TT format)\n";
       }
       continue;
     }
 
+    if (cmd == "position") {
+      setPosition(line);
+      continue;
+    }
+
     if (cmd == "go") {
       int depth = -1;
       int movetime = -1;
       int wtime = -1, btime = -1, winc = 0, binc = 0, movestogo = 0;
       bool infinite = false;
       bool ponder = false;
+      int perftDepth = 0;
+      engine::SearchLimits goLimits;
+      std::vector<std::string> searchMoves;
       for (size_t i = 1; i < tokens.size(); ++i) {
         if (tokens[i] == "depth" && i + 1 < tokens.size()) {
           depth = std::stoi(tokens[++i]);
@@ -287,64 +544,99 @@ int UCI::run() {
           infinite = true;
         } else if (tokens[i] == "ponder") {
           ponder = true;
+        } else if (tokens[i] == "perft" && i + 1 < tokens.size()) {
+          perftDepth = std::stoi(tokens[++i]);
+        } else if (tokens[i] == "nodes" && i + 1 < tokens.size()) {
+          goLimits.nodes = std::stoull(tokens[++i]);
+        } else if (tokens[i] == "mate" && i + 1 < tokens.size()) {
+          goLimits.mate = std::stoi(tokens[++i]);
+        } else if (tokens[i] == "searchmoves") {
+          // Züge bis zum nächsten Schlüsselwort
+          while (i + 1 < tokens.size() && is_move_token(tokens[i + 1]))
+            searchMoves.push_back(tokens[++i]);
         }
       }
 
-      {
+      stop_search();
+
+      // searchmoves gegen die legalen Züge der aktuellen Stellung auflösen
+      if (!searchMoves.empty()) {
+        for (const auto& m : m_game.generateLegalMoves())
+          if (std::find(searchMoves.begin(), searchMoves.end(), move_to_uci(m)) !=
+              searchMoves.end())
+            goLimits.searchMoves.push_back(m);
+      }
+
+      // "go perft N": im Hintergrund wie eine Suche (stop/isready/quit bleiben bedienbar), mit
+      // den Threads der Session und einer Kopie der Stellung
+      if (perftDepth > 0) {
+        const int threads = engineSession().getConfig().threads;
+        cancelToken.store(false);
         std::lock_guard<std::mutex> lk(stateMutex);
-        if (searchRunning) {
-          cancelToken.store(true);
-          if (printerThread.joinable()) printerThread.join();
+        searchRunning = true;
+        printerThread = std::thread([pos = m_game.getPositionRefForBot(), perftDepth, threads,
+                                     &stateMutex, &searchRunning, &cancelToken]() {
+          print_perft(engine::run_perft(pos, perftDepth, threads, engine::PERFT_HASH_MB,
+                                        &cancelToken));
+          std::lock_guard<std::mutex> lk2(stateMutex);
           searchRunning = false;
-          cancelToken.store(false);
-        }
+        });
+        continue;
       }
 
-      // determine think time
-      int thinkMillis = 0;
-      if (movetime > 0)
-        thinkMillis = movetime;
-      else if (!infinite && !(ponder && m_options.ponder)) {
-        int timeLeft = (m_game.getGameState().sideToMove == core::Color::White ? wtime : btime);
-        int inc = (m_game.getGameState().sideToMove == core::Color::White ? winc : binc);
-        if (timeLeft >= 0) {
-          if (movestogo > 0)
-            thinkMillis = timeLeft / movestogo;
-          else
-            thinkMillis = timeLeft / 30;
-          thinkMillis += inc;
-          thinkMillis -= m_options.moveOverhead;
-          if (thinkMillis < 0) thinkMillis = 0;
-        }
-      }
+      // Zeitvorgaben: Soll-/Maximalzeit verteilt der TimeManager in der Suche
+      const bool white = m_game.getGameState().sideToMove == core::Color::White;
+      engine::TimeLimits limits;
+      limits.timeLeft = white ? wtime : btime;
+      limits.inc = white ? winc : binc;
+      limits.movestogo = movestogo;
+      limits.movetime = movetime;
+      limits.moveOverhead = m_options.moveOverhead;
+      limits.infinite = infinite;
+      limits.ponder = ponder;
 
       cancelToken.store(false);
+      engine::BotEngine& engine = engineSession();
+      // Uhr hier starten: ein ponderhit direkt nach "go ponder" darf nicht vor dem Suchstart
+      // verloren gehen
+      engine.startClock(limits);
       {
         std::lock_guard<std::mutex> lk(stateMutex);
-        auto cfg = m_options.toEngineConfig();
+        pondering = ponder;
         searchFuture = std::async(
-            std::launch::async, [this, depth, thinkMillis, &cancelToken, cfg]() -> model::Move {
-              lilia::engine::BotEngine engine(cfg);
+            std::launch::async,
+            [this, &engine, depth, limits, goLimits, &cancelToken]() -> engine::SearchResult {
               auto res = engine.findBestMove(m_game, (depth > 0 ? depth : /*some default*/ 0),
-                                             thinkMillis, &cancelToken);
-              if (res.bestMove.has_value()) return res.bestMove.value();
-              return model::Move{};
+                                             limits, &cancelToken, goLimits);
+              return res;
             });
 
         searchRunning = true;
 
-        printerThread = std::thread([&searchFuture, &stateMutex, &searchRunning, &cancelToken]() {
-          model::Move best;
+        printerThread = std::thread([&searchFuture, &stateMutex, &searchRunning, &cancelToken,
+                                     &pondering, &ponderCv]() {
+          engine::SearchResult res;
           try {
-            best = searchFuture.get();
+            res = searchFuture.get();
           } catch (...) {
-            best = model::Move{};
+            res = engine::SearchResult{};
+          }
+          print_search_info(res.stats);
+          {
+            std::unique_lock<std::mutex> lk2(stateMutex);
+            ponderCv.wait(lk2, [&] { return !pondering; });
           }
 
+          const model::Move best = res.bestMove.value_or(model::Move{});
           if (best.from() >= 0 && best.to() >= 0) {
-            std::cout << "bestmove " << move_to_uci(best) << "\n";
+            UciLine out;
+            out << "bestmove " << move_to_uci(best);
+            // Erwartete Antwort aus der PV – darauf pondert die GUI als nächstes
+            const auto& pv = res.stats.bestPV;
+            if (pv.size() >= 2 && pv[0] == best) out << " ponder " << move_to_uci(pv[1]);
+            out << "\n";
           } else {
-            std::cout << "bestmove 0000\n";
+            uci_out() << "bestmove 0000\n";
           }
 
           {
@@ -359,40 +651,38 @@ int UCI::run() {
     }
 
     if (cmd == "stop") {
-      cancelToken.store(true);
-      {
-        std::lock_guard<std::mutex> lk(stateMutex);
-        if (searchRunning && printerThread.joinable()) {
-          printerThread.join();
-          searchRunning = false;
-          cancelToken.store(false);
-        }
-      }
+      stop_search();
+      continue;
+    }
+
+    if (cmd == "bench") {
+      stop_search();
+      (void)bench(std::vector<std::string>(tokens.begin() + 1, tokens.end()));
       continue;
     }
 
+    // Die GUI hat den erwarteten Zug gespielt: dieselbe Suche läuft mit Uhr weiter
+    // (TT, History und die schon gerechnete Zeit bleiben erhalten)
     if (cmd == "ponderhit") {
-      // no special handling needed in this simple engine
+      // false: die Suche ist schon fertig und wartet nur noch auf die Freigabe von bestmove
+      if (!m_engine || !m_engine->ponderhit()) {
+        LILIA_LOG(Debug, Uci) << "ponderhit without running search";
+      }
+      release_ponder();
       continue;
     }
 
     if (cmd == "quit") {
-      cancelToken.store(true);
-      {
-        std::lock_guard<std::mutex> lk(stateMutex);
-        if (searchRunning && printerThread.joinable()) {
-          printerThread.join();
-        }
-      }
+      stop_search();
       break;
     }
   }
 
-  {
-    std::lock_guard<std::mutex> lk(stateMutex);
-    if (searchRunning && printerThread.joinable()) printerThread.join();
-  }
+  // EOF ohne quit: laufende Suche regulär zu Ende rechnen lassen
+  release_ponder();
+  if (printerThread.joinable()) printerThread.join();
 
+  uci_flush();
   return 0;
 }
 
@@ -2,6 +2,9 @@
 #include <cmath>
 #include <atomic>
 #include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <future>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -10,7 +13,9 @@
 #include "lilia/engine/eval.hpp"
 #include "lilia/engine/eval_shared.hpp"
 #include "lilia/engine/eval_alias.hpp"
+#include "lilia/engine/perft.hpp"
 #include "lilia/engine/search.hpp"
+#include "lilia/engine/search_threads.hpp"
 #include "lilia/model/chess_game.hpp"
 #include "lilia/model/tt5.hpp"
 #include "lilia/uci/uci_helper.hpp"
@@ -151,6 +156,7 @@ int main() {
   {
     model::ChessGame game;
     game.setPosition("8/5k2/5p2/pp6/2pB4/P1P3K1/1n1r1P2/1R6 b - - 8 49");
+    bot.newGame();  // unrelated position: start from fresh heuristics
     auto res = bot.findBestMove(game, 6, 0);
     assert(res.bestMove);
     model::Move expected(sq('d', 2), sq('d', 4));
@@ -194,6 +200,7 @@ int main() {
   {
     model::ChessGame game;
     game.setPosition("r1b1rk2/4qp2/p4R2/np4Q1/3PP3/PBPRp3/1P2N1Pb/7K b - - 0 27");
+    bot.newGame();
     auto res = bot.findBestMove(game, 4, 0);
     assert(res.bestMove);
     model::Move expected(sq('a', 5), sq('b', 3));
@@ -216,7 +223,8 @@ int main() {
   {
     model::ChessGame game;
     game.setPosition("6k1/3b1ppp/p7/3R4/2P2p2/7q/4KQ2/8 b - - 1 66");
-    auto res = bot.findBestMove(game, 8, 0);
+    bot.newGame();
+    auto res = bot.findBestMove(game, 9, 0);
     assert(res.bestMove);
     model::Move expected(sq('h', 3), sq('h', 6));
     if (!res.bestMove || *res.bestMove != expected) {
@@ -230,6 +238,7 @@ int main() {
   {
     model::ChessGame game;
     game.setPosition("4kb1r/prQ1p1pp/4q3/3b1p2/1n1PP3/5P2/PP1N2PP/R1B1KB1R w KQk - 1 15");
+    bot.newGame();
     auto res = bot.findBestMove(game, 12, 0);
     assert(res.bestMove);
     model::Move expected(sq('c', 7), sq('c', 5));
@@ -240,6 +249,36 @@ int main() {
     }
   }
 
+  // Regression: the session keeps killers/histories between searches. A second search on the
+  // same BotEngine once never finished (quiet check -> evasion -> quiet check chains in
+  // qsearch down to MAX_PLY); both fixed-depth searches must come back.
+  {
+    bot.newGame();
+    model::ChessGame first;
+    first.setPosition("6k1/3b1ppp/p7/3R4/2P2p2/7q/4KQ2/8 b - - 1 66");
+    auto res1 = bot.findBestMove(first, 9, 0);
+    if (!res1.bestMove) {
+      std::cerr << "First session search returned no move\n";
+      return 1;
+    }
+
+    model::ChessGame second;
+    second.setPosition("4kb1r/prQ1p1pp/4q3/3b1p2/1n1PP3/5P2/PP1N2PP/R1B1KB1R w KQk - 1 15");
+    std::atomic<bool> cancel{false};
+    auto fut = std::async(std::launch::async,
+                          [&] { return bot.findBestMove(second, 10, 0, &cancel); });
+    if (fut.wait_for(std::chrono::seconds(60)) != std::future_status::ready) {
+      cancel.store(true);
+      fut.wait();
+      std::cerr << "Second search in the same session did not finish\n";
+      return 1;
+    }
+    if (!fut.get().bestMove) {
+      std::cerr << "Second session search returned no move\n";
+      return 1;
+    }
+  }
+
   // Regression: detect fianchetto bonus for a long-castled king protected by the b-pawn.
   {
     engine::Evaluator eval;
@@ -265,5 +304,457 @@ int main() {
     assert(scoreB3 - scoreB4 >= expectedSwing - 2);
   }
 
+  // key_after() must predict the child's hash and pawn key (castling, EP, promotions)
+  {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+        "4k3/8/8/8/1p1p4/8/P1P1P3/4K3 w - - 0 1",
+    };
+    model::MoveGenerator gen;
+    auto walk = [&](auto& self, model::Position& pos, int depth) -> bool {
+      std::vector<model::Move> moves;
+      gen.generatePseudoLegalMoves(pos.getBoard(), pos.getState(), moves);
+      for (const auto& m : moves) {
+        const auto ck = pos.key_after(m);
+        if (!pos.doMove(m)) continue;
+        const bool ok = ck.key == pos.hash() && ck.pawnKey == pos.getState().pawnKey &&
+                        (depth <= 1 || self(self, pos, depth - 1));
+        pos.undoMove();
+        if (!ok) {
+          std::cerr << "key_after mismatch for " << move_to_uci(m) << "\n";
+          return false;
+        }
+      }
+      return true;
+    };
+    for (const char* fen : fens) {
+      model::ChessGame game;
+      game.setPosition(fen);
+      if (!walk(walk, game.getPositionRefForBot(), 3)) return 1;
+    }
+
+    // ChessGame::doMove checks a single move; it must accept exactly the legal ones
+    const core::PieceType promos[] = {core::PieceType::None, core::PieceType::Knight,
+                                      core::PieceType::Bishop, core::PieceType::Rook,
+                                      core::PieceType::Queen};
+    for (const char* fen : fens) {
+      model::ChessGame game;
+      game.setPosition(fen);
+      const std::vector<model::Move> legal = game.generateLegalMoves();
+      for (int from = 0; from < 64; ++from)
+        for (int to = 0; to < 64; ++to)
+          for (auto pr : promos) {
+            const auto f = static_cast<core::Square>(from), t = static_cast<core::Square>(to);
+            const bool isLegal = std::any_of(legal.begin(), legal.end(), [&](const model::Move& m) {
+              return m.from() == f && m.to() == t && m.promotion() == pr;
+            });
+            model::ChessGame g = game;
+            if (g.doMove(f, t, pr) != isLegal) {
+              std::cerr << "ChessGame::doMove disagrees with movegen on " << fen << " "
+                        << move_to_uci(model::Move(f, t, pr)) << "\n";
+              return 1;
+            }
+          }
+    }
+  }
+
+  // Lazy SMP with persistent helpers: several searches in a row on the same thread group,
+  // resized in between; every search must return a legal move and count helper nodes.
+  {
+    model::TT5 tt(16);
+    auto evalPtr = std::make_shared<const engine::Evaluator>();
+    engine::Search search(tt, evalPtr, cfg);
+    engine::SearchThreads helpers(tt, evalPtr, cfg);
+
+    const std::string fens[] = {
+        core::START_FEN,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+    for (int helperCount : {2, 2, 1, 3}) {
+      helpers.resize(helperCount);
+      for (const auto& fen : fens) {
+        model::ChessGame game;
+        game.setPosition(fen);
+        auto& pos = game.getPositionRefForBot();
+        auto stop = std::make_shared<std::atomic<bool>>(false);
+        search.search_root_lazy_smp(pos, 5, stop, helpers);
+        const auto& stats = search.getStats();
+        model::Position tmp = pos;
+        if (!stats.bestMove || !tmp.doMove(*stats.bestMove)) {
+          std::cerr << "Lazy SMP (" << helperCount << " helpers) returned no legal move on "
+                    << fen << "\n";
+          return 1;
+        }
+        if (stats.nodes == 0) {
+          std::cerr << "Lazy SMP reported no nodes on " << fen << "\n";
+          return 1;
+        }
+      }
+    }
+    helpers.clear();
+  }
+
+  // Perft suite: start position, Kiwipete & Co. plus EP/castling/promotion edge cases.
+  // Threaded + hashed must agree with the reference counts and with a plain single-thread run.
+  {
+    struct PerftCase {
+      const char* fen;
+      int depth;
+      std::uint64_t nodes;
+    };
+    const PerftCase cases[] = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 4, 197281},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890},
+        {"8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1", 6, 824064},         // EP deckt Schach auf
+        {"8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467},       // EP aus dem Schach
+        {"r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206},  // Rochade durch Angriff
+        {"r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4, 1720476},   // Rochaderechte verlieren
+        {"2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001},           // Umwandlung ins Schach
+    };
+    for (const auto& c : cases) {
+      model::ChessGame game;
+      game.setPosition(c.fen);
+      const auto r = engine::run_perft(game.getPositionRefForBot(), c.depth, 4, 8);
+      if (r.nodes != c.nodes) {
+        std::cerr << "perft " << c.depth << " of " << c.fen << " = " << r.nodes << ", expected "
+                  << c.nodes << "\n";
+        return 1;
+      }
+    }
+    model::ChessGame game;
+    game.setPosition(cases[1].fen);
+    const auto plain = engine::run_perft(game.getPositionRefForBot(), 3, 1, 0);
+    const auto fast = engine::run_perft(game.getPositionRefForBot(), 3, 4, 8);
+    if (plain.nodes != cases[1].nodes || plain.divide.size() != 48 ||
+        plain.divide.size() != fast.divide.size() ||
+        !std::equal(plain.divide.begin(), plain.divide.end(), fast.divide.begin())) {
+      std::cerr << "perft divide differs between threaded/hashed and plain run\n";
+      return 1;
+    }
+  }
+
+  // Legal generation must equal pseudo-legal + doMove filtering (incl. in-check EP capturing the
+  // checker), and doMoveLegal must leave the same hash as doMove, two plies deep.
+  {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1",
+        "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",
+        "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1",  // EP schlägt den Schachgeber
+        "4k3/8/8/2KPp2r/8/8/8/8 w - e6 0 1",  // EP deckt Turm auf
+    };
+    model::MoveGenerator mg;
+    auto legal_set = [&](model::Position& p) {
+      std::vector<model::Move> legal;
+      mg.generateLegalMoves(p.getBoard(), p.getState(), legal);
+      std::vector<std::uint32_t> raw;
+      for (const auto& m : legal) raw.push_back(m.raw);
+      std::sort(raw.begin(), raw.end());
+      return raw;
+    };
+    auto filtered_set = [&](model::Position& p) {
+      std::vector<model::Move> pseudo;
+      mg.generatePseudoLegalMoves(p.getBoard(), p.getState(), pseudo);
+      std::vector<model::Move> evasions;
+      if (p.inCheck()) {
+        mg.generateEvasions(p.getBoard(), p.getState(), evasions);
+        pseudo.insert(pseudo.end(), evasions.begin(), evasions.end());
+      }
+      std::vector<std::uint32_t> raw;
+      for (const auto& m : pseudo) {
+        if (!p.doMove(m)) continue;
+        p.undoMove();
+        raw.push_back(m.raw);
+      }
+      std::sort(raw.begin(), raw.end());
+      raw.erase(std::unique(raw.begin(), raw.end()), raw.end());
+      return raw;
+    };
+    for (const char* fen : fens) {
+      model::ChessGame game;
+      game.setPosition(fen);
+      auto& pos = game.getPositionRefForBot();
+      std::vector<model::Move> rootMoves;
+      mg.generateLegalMoves(pos.getBoard(), pos.getState(), rootMoves);
+      if (legal_set(pos) != filtered_set(pos)) {
+        std::cerr << "legal movegen differs from doMove filter in " << fen << "\n";
+        return 1;
+      }
+      for (const auto& m : rootMoves) {
+        model::Position viaCheck = pos;
+        const bool ok = viaCheck.doMove(m);
+        pos.doMoveLegal(m);
+        if (!ok || viaCheck.hash() != pos.hash() || legal_set(pos) != filtered_set(pos)) {
+          std::cerr << "legal movegen differs from doMove filter below " << fen << "\n";
+          return 1;
+        }
+        pos.undoMove();
+      }
+    }
+  }
+
+  // givesCheck() from the incremental CheckInfo must predict the check after doMove
+  // (direct, discovered, promotion, EP and castling checks), also after undo and null moves.
+  {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1",
+        "5k2/8/8/8/8/8/8/4K2R w K - 0 1",                // Rochade gibt Schach
+        "8/8/8/8/r2Pp2K/8/8/k7 b - d3 0 1",              // EP öffnet die Reihe
+        "4k3/8/8/4N3/8/8/8/4R1K1 w - - 0 1",             // Abzugsschach
+    };
+    model::MoveGenerator mg;
+    for (const char* fen : fens) {
+      model::ChessGame game;
+      game.setPosition(fen);
+      auto& pos = game.getPositionRefForBot();
+      std::vector<model::Move> moves;
+      mg.generateLegalMoves(pos.getBoard(), pos.getState(), moves);
+      const auto before = pos.checkInfo().checkers;
+      for (const auto& m : moves) {
+        const bool predicted = pos.givesCheck(m);
+        pos.doMoveLegal(m);
+        const bool actual = pos.lastMoveGaveCheck() && pos.inCheck();
+        std::vector<model::Move> replies;
+        mg.generateLegalMoves(pos.getBoard(), pos.getState(), replies);
+        bool repliesOk = true;
+        for (const auto& r : replies) {
+          const bool p2 = pos.givesCheck(r);
+          pos.doMoveLegal(r);
+          repliesOk &= (p2 == pos.inCheck());
+          pos.undoMove();
+        }
+        pos.undoMove();
+        if (predicted != actual || !repliesOk || pos.checkInfo().checkers != before) {
+          std::cerr << "givesCheck mismatch for " << move_to_uci(m) << " in " << fen << "\n";
+          return 1;
+        }
+      }
+      if (!pos.inCheck() && pos.doNullMove()) {
+        const bool ok = !pos.inCheck();
+        pos.undoNullMove();
+        if (!ok || pos.checkInfo().checkers != before) {
+          std::cerr << "check info not restored around null move in " << fen << "\n";
+          return 1;
+        }
+      }
+    }
+  }
+
+  // The history ring must keep repetitions visible past its capacity and in tail copies
+  {
+    model::ChessGame game;
+    game.setPosition(core::START_FEN);
+    auto& pos = game.getPositionRefForBot();
+    const model::Move shuffle[4] = {model::Move(sq('g', 1), sq('f', 3)),
+                                    model::Move(sq('g', 8), sq('f', 6)),
+                                    model::Move(sq('f', 3), sq('g', 1)),
+                                    model::Move(sq('f', 6), sq('g', 8))};
+    bool ok = true;
+    for (int i = 0; i < 4 * model::STATE_STACK_SIZE && ok; ++i) {
+      ok = pos.doMove(shuffle[i % 4]);
+      if (ok && i >= 7) {
+        model::Position copy = pos;
+        ok = pos.checkRepetition() && copy.checkRepetition() && copy.hash() == pos.hash();
+      }
+    }
+    for (int i = 0; i < 8 && ok; ++i) pos.undoMove();
+    if (!ok || !pos.checkRepetition()) {
+      std::cerr << "repetition lost in history ring or Position copy\n";
+      return 1;
+    }
+  }
+
+  // upcomingRepetition: after Nf3 Nf6 Ng1 Black can restore the start position with Ng8
+  {
+    model::ChessGame game;
+    game.setPosition(core::START_FEN);
+    auto& pos = game.getPositionRefForBot();
+    const model::Move line[3] = {model::Move(sq('g', 1), sq('f', 3)),
+                                 model::Move(sq('g', 8), sq('f', 6)),
+                                 model::Move(sq('f', 3), sq('g', 1))};
+    bool ok = true;
+    for (const auto& m : line) ok = ok && pos.doMove(m);
+    // innerhalb der Suche reicht die zweite Wiederholung, vor der Wurzel nicht
+    ok = ok && pos.upcomingRepetition(4) && !pos.upcomingRepetition(0);
+    // ein Nullzug dazwischen bricht die Kette, ein Bauernzug ebenso
+    if (ok && pos.doNullMove()) {
+      ok = !pos.upcomingRepetition(4);
+      pos.undoNullMove();
+    }
+    ok = ok && pos.doMove(model::Move(sq('d', 7), sq('d', 5))) && !pos.upcomingRepetition(8);
+    if (!ok) {
+      std::cerr << "upcomingRepetition missed or invented a repetition\n";
+      return 1;
+    }
+  }
+
+  // upcomingRepetition must agree with trying every legal move on random walks
+  {
+    const char* fens[] = {
+        "4k3/8/2n5/8/3r4/8/2RN4/4K3 w - - 0 1",
+        "8/3k4/8/1q6/8/4Q3/3K4/8 w - - 0 1",
+        "r3k3/8/8/8/8/8/8/R3K2R w KQq - 0 1",  // Rochaderechte ändern den Key
+    };
+    model::MoveGenerator mg;
+    std::uint32_t rng = 12345;
+    int found = 0;
+    for (const char* fen : fens) {
+      model::ChessGame game;
+      game.setPosition(fen);
+      auto& pos = game.getPositionRefForBot();
+      std::vector<std::uint64_t> keys{pos.hash()};  // seit dem letzten irreversiblen Zug
+      for (int step = 0; step < 400; ++step) {
+        std::vector<model::Move> moves;
+        mg.generateLegalMoves(pos.getBoard(), pos.getState(), moves);
+        if (moves.empty() || pos.checkMoveRule()) break;
+        bool brute = false;
+        for (const auto& m : moves) {
+          pos.doMoveLegal(m);
+          for (std::size_t k = keys.size() % 2; k + 1 < keys.size() && !brute; k += 2)
+            brute = keys[k] == pos.hash() && pos.getState().halfmoveClock > 0;
+          pos.undoMove();
+        }
+        // der ganze Weg zählt als Suchpfad, also reicht jede frühere Stellung
+        if (brute != pos.upcomingRepetition(step + 1)) {
+          std::cerr << "upcomingRepetition disagrees with move search in " << fen << "\n";
+          return 1;
+        }
+        found += brute;
+        rng = rng * 1664525u + 1013904223u;
+        pos.doMoveLegal(moves[(rng >> 8) % moves.size()]);
+        if (pos.getState().halfmoveClock == 0) keys.clear();
+        keys.push_back(pos.hash());
+      }
+    }
+    if (found == 0) {
+      std::cerr << "random walks never reached an upcoming repetition\n";
+      return 1;
+    }
+  }
+
+  // Threshold SEE must agree with the exact swap values, which know a few fixed exchanges
+  {
+    struct SeeCase {
+      const char* fen;
+      model::Move m;
+      int value;
+    };
+    const SeeCase seeCases[] = {
+        {"4k3/8/3p4/4p3/3Q4/8/8/4K3 w - - 0 1", model::Move(sq('d', 4), sq('e', 5)), 100 - 950},
+        {"4k3/8/8/4p3/3P4/8/8/4K3 w - - 0 1", model::Move(sq('d', 4), sq('e', 5)), 100},
+        // Turm hinter Turm: X-Ray über e2 hält e5 nach RxP, RxR
+        {"4r1k1/8/8/4p3/8/8/4R3/4R1K1 w - - 0 1", model::Move(sq('e', 2), sq('e', 5)), 100},
+        // der Springer f6 ist gefesselt und schlägt nicht zurück
+        {"7k/8/5n2/3p4/3B4/1B6/8/K7 w - - 0 1", model::Move(sq('b', 3), sq('d', 5)), 100},
+        // ruhiger Zug auf ein gedecktes Feld riskiert die Figur
+        {"6k1/8/8/8/8/5n2/8/K2R4 w - - 0 1", model::Move(sq('d', 1), sq('d', 4)), -500},
+    };
+    for (const auto& c : seeCases) {
+      model::ChessGame game;
+      game.setPosition(c.fen);
+      auto& pos = game.getPositionRefForBot();
+      const model::Move m = pos.resolveMove(c.m).value_or(c.m);
+      int v = 0;
+      pos.see_values(&m, 1, &v);
+      if (v != c.value || !pos.see_ge(m, v) || pos.see_ge(m, v + 1)) {
+        std::cerr << "SEE of " << move_to_uci(m) << " is " << v << ", expected " << c.value
+                  << " in " << c.fen << "\n";
+        return 1;
+      }
+    }
+
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r1b1rk2/4qp2/p4R2/np4Q1/3PP3/PBPRp3/1P2N1Pb/7K b - - 0 27",
+        "2r2rk1/1bqnbppp/p2ppn2/1p6/3NP3/1BN1BP2/PPPQ2PP/2KR3R w - - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+    model::MoveGenerator mg;
+    for (const char* fen : fens) {
+      model::ChessGame game;
+      game.setPosition(fen);
+      auto& pos = game.getPositionRefForBot();
+      std::vector<model::Move> moves;
+      mg.generateLegalMoves(pos.getBoard(), pos.getState(), moves);
+      std::vector<int> values(moves.size());
+      pos.see_values(moves.data(), (int)moves.size(), values.data());
+      for (std::size_t i = 0; i < moves.size(); ++i) {
+        if (!pos.see_ge(moves[i], values[i]) || pos.see_ge(moves[i], values[i] + 1)) {
+          std::cerr << "see_ge disagrees with SEE value " << values[i] << " for "
+                    << move_to_uci(moves[i]) << " in " << fen << "\n";
+          return 1;
+        }
+      }
+    }
+  }
+
+  // Every TT layout must round-trip an entry and let a deeper store of the same key win
+  {
+    auto roundTrip = [](auto& tt, const char* name) {
+      const std::uint64_t key = 0x9D39247E33776D41ull;
+      const model::Move mv(sq('g', 1), sq('f', 3));
+      tt.store(key, -123, 7, model::Bound::Lower, mv, 45);
+      tt.store(key, 88, 9, model::Bound::Exact, mv);
+
+      model::TTEntry5 e{};
+      if (!tt.probe_into(key, e) || e.value != 88 || e.depth != 9 ||
+          e.bound != model::Bound::Exact || e.best.from() != mv.from() || e.best.to() != mv.to()) {
+        std::cerr << "TT layout " << name << " failed to round-trip an entry\n";
+        return false;
+      }
+      if (tt.probe_into(key ^ 0xFFFFull, e)) return false;
+#if TT5_STATS
+      const model::TTStats st = tt.stats();
+      if (st.probes != 2 || st.hits != 1 || st.stores != 2 || st.emptyWrites != 1 ||
+          st.sameKeyWrites != 1) {
+        std::cerr << "TT layout " << name << " miscounted probes/stores\n";
+        return false;
+      }
+#endif
+      // fill every cluster: the sampled part must read as full for this generation
+      for (std::uint64_t i = 1; i <= 64 * tt.slots(); ++i)
+        tt.store(i * 0x9E3779B97F4A7C15ull, 1, 1, model::Bound::Upper, mv);
+      if (tt.hashfull() < 900) {
+        std::cerr << "TT layout " << name << " reports hashfull " << tt.hashfull() << "\n";
+        return false;
+      }
+      return true;
+    };
+    model::BasicTT5<model::TTLayoutPacked4> packed(1);
+    model::BasicTT5<model::TTLayoutCompact6> compact(1);
+    if (!roundTrip(packed, packed.layout_name()) || !roundTrip(compact, compact.layout_name()))
+      return 1;
+  }
+
+  // A saved TT must come back from disk with its entries and size
+  {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "lilia_tt_roundtrip.tt").string();
+    const std::uint64_t key = 0x0123456789ABCDEFull;
+    model::TT5 saved(2);
+    saved.store(key, 77, 12, model::Bound::Exact, model::Move(sq('e', 2), sq('e', 4)));
+    saved.new_generation();
+
+    model::TT5 loaded(1);
+    model::TTEntry5 e{};
+    const bool ok = saved.save(path) && loaded.load(path) && loaded.slots() == saved.slots() &&
+                    loaded.probe_into(key, e) && e.value == 77 && e.depth == 12;
+    std::filesystem::remove(path);
+    if (!ok) {
+      std::cerr << "TT save/load round trip failed\n";
+      return 1;
+    }
+  }
+
   return 0;
 }